@@ -0,0 +1,97 @@
+#!/bin/bash
+# Code generation throughput of lpc in MB/s. The same program is compiled twice:
+# with --emit= (parse, check and optimize, without generating code) and with
+# --filter (the same plus code generation and the peephole pass, written to
+# /dev/null). The difference of the times is the time spent generating code, and
+# the size of the generated code divided by it is the throughput. Each time is the
+# best of a few runs.
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+
+# Number of functions of the program, can be given as an argument
+FUNCTIONS=${1:-20000}
+RUNS=${RUNS:-5}
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+# Write an L+ program with N functions with loops, conditions, floats and calls
+function generate
+{
+	awk -v n=$1 'BEGIN {
+		print "int total;"
+		for (i = 0; i < n; i++) {
+			print "int f" i "(int x, float y)"
+			print "{"
+			print "\tint i = 0;"
+			print "\tint a = x * " i " + 1;"
+			print "\tfloat b = y / 2.5 + a;"
+			print "\tstring s = \"f" i "\";"
+			print "\twhile (i < x)"
+			print "\t{"
+			print "\t\ta = a + i * (x - 1) + " i ";"
+			print "\t\tif (a > 1000 && b < 3.5) { a = a - 1000; } else { b = b + 1.5; }"
+			print "\t\ti = i + 1;"
+			print "\t}"
+			if (i > 0) {
+				print "\ta = a + f" (i - 1) "(a, b);"
+			}
+			print "\ttotal = total + a;"
+			print "\tprint(s + toString(b));"
+			print "\treturn a;"
+			print "}"
+		}
+		print "void main()"
+		print "{"
+		print "\tprint(toString(f" (n - 1) "(3, 1.0)));"
+		print "}"
+	}'
+}
+
+# Best wall time of RUNS runs of lpc, in microseconds
+function best
+{
+	min=0
+	for r in `seq $RUNS`; do
+		start=`date +%s%N`
+		(cd $DIR && "$LPC" "$@" > /dev/null 2>&1)
+		if [ $? -ne 0 ]; then
+			echo "lpc failed, aborting..." >&2
+			exit 1
+		fi
+		end=`date +%s%N`
+		t=$(((end - start) / 1000))
+		if [ $min -eq 0 ] || [ $t -lt $min ]; then
+			min=$t
+		fi
+	done
+	echo $min
+}
+
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+generate $FUNCTIONS > $DIR/codegen.lp
+
+bytes=`cd $DIR && "$LPC" --filter codegen.lp 2> /dev/null | wc -c`
+front=`best codegen.lp --emit=` || exit 1
+whole=`best codegen.lp --filter` || exit 1
+codegen=$((whole - front))
+if [ $codegen -le 0 ]; then
+	codegen=1
+fi
+
+echo "functions:          $FUNCTIONS"
+echo "generated code:     $((bytes / 1024)) KB"
+echo "without codegen:    $((front / 1000)) ms"
+echo "with codegen:       $((whole / 1000)) ms"
+echo "codegen:            $((codegen / 1000)) ms"
+echo "throughput:         $((bytes / codegen)) MB/s"
+
+rm -rf $DIR
@@ -0,0 +1,91 @@
+#!/bin/bash
+# Stress test for very deep expressions. Each program has a chain of N "+"
+# terms, N nested parentheses, N "!" operators and N nested function calls
+# inside a while loop, so every pass (optimizer, semantic checks, loop
+# invariant motion and code generation) goes through trees N levels deep. lpc runs with a small native stack (1MB):
+# it must not crash no matter how deep the expression is.
+# The generated code is far beyond the JVM method size limits, only lpc is tested.
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+
+# Sizes to test, can be given as arguments
+SIZES="$@"
+if [ "$SIZES" == "" ]; then
+	SIZES="10000 100000 1000000"
+fi
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+# Write an L+ program with expressions N levels deep
+function generate
+{
+	echo "int h(int a)"
+	echo "{"
+	echo "	return a;"
+	echo "}"
+	echo "void main()"
+	echo "{"
+	echo "	int x = 1;"
+	echo "	int i = 0;"
+	echo "	while (i < 1)"
+	echo "	{"
+	echo -n "		int y = x"
+	for ((j = 1; j < $1; j++)); do
+		echo -n " + i"
+	done
+	echo ";"
+	echo -n "		int z = "
+	for ((j = 0; j < $1; j++)); do
+		echo -n "("
+	done
+	echo -n "x + i"
+	for ((j = 0; j < $1; j++)); do
+		echo -n ")"
+	done
+	echo ";"
+	echo -n "		bool b = "
+	for ((j = 0; j < $1; j++)); do
+		echo -n "!"
+	done
+	echo "(y < z);"
+	echo -n "		int c = "
+	for ((j = 0; j < $1; j++)); do
+		echo -n "h("
+	done
+	echo -n "x + i"
+	for ((j = 0; j < $1; j++)); do
+		echo -n ")"
+	done
+	echo ";"
+	echo "		i = i + 1;"
+	echo "	}"
+	echo "	print(toString(i));"
+	echo "}"
+}
+
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+
+echo "depth	seconds"
+for n in $SIZES; do
+	generate $n > $DIR/deep$n.lp
+	START=`date +%s.%N`
+	(ulimit -s 1024; cd $DIR && "$LPC" deep$n.lp > /dev/null)
+	if [ $? -ne 0 ]; then
+		echo "lpc failed compiling an expression $n levels deep, aborting..."
+		rm -rf $DIR
+		exit 1
+	fi
+	END=`date +%s.%N`
+	awk -v n=$n -v s=$START -v e=$END 'BEGIN { printf "%d\t%.3f\n", n, e - s }'
+done
+
+rm -rf $DIR
@@ -0,0 +1,155 @@
+#!/bin/bash
+# Deterministic generator of synthetic L+ programs, to measure how the compile
+# time grows with each dimension of the source. The same options and seed
+# always give the same program (with the same awk). Every function writes a
+# global, so none of them is pure and the compiler does not evaluate them at
+# compile time.
+#
+# Usage: genprog.sh [options] > program.lp
+#   -f N   number of functions (default 100)
+#   -b N   statements in the body of each function (default 20)
+#   -d N   depth of each expression, in operators (default 4)
+#   -i N   identifiers: number of globals and of locals of each function (default 8)
+#   -n N   nesting depth of if and while blocks (default 2)
+#   -s N   percentage of statements that build strings (default 10)
+#   -r N   random seed (default 1)
+
+FUNCTIONS=100
+BODY=20
+DEPTH=4
+IDENTS=8
+NESTING=2
+STRINGS=10
+SEED=1
+
+while getopts "f:b:d:i:n:s:r:" opt; do
+	case $opt in
+		f)	FUNCTIONS=$OPTARG;;
+		b)	BODY=$OPTARG;;
+		d)	DEPTH=$OPTARG;;
+		i)	IDENTS=$OPTARG;;
+		n)	NESTING=$OPTARG;;
+		s)	STRINGS=$OPTARG;;
+		r)	SEED=$OPTARG;;
+		*)	echo "Usage: $0 [-f functions] [-b body] [-d depth] [-i identifiers] [-n nesting] [-s strings%] [-r seed]" >&2
+			exit 1;;
+	esac
+done
+
+awk -v functions=$FUNCTIONS -v body=$BODY -v depth=$DEPTH -v idents=$IDENTS \
+	-v nesting=$NESTING -v strings=$STRINGS -v seed=$SEED '
+
+# Random integer between 0 and n - 1
+function rnd(n)
+{
+	return int(rand() * n)
+}
+
+function tabs(n,    t)
+{
+	t = ""
+	while (n-- > 0) {
+		t = t "\t"
+	}
+	return t
+}
+
+# A visible variable: a global, a local or the parameter
+function variable(    r)
+{
+	r = rnd(idents * 2 + 1)
+	if (r < idents) {
+		return "g" r
+	}
+	if (r < idents * 2) {
+		return "v" (r - idents)
+	}
+	return "a"
+}
+
+function leaf()
+{
+	if (rnd(3) == 0) {
+		return rnd(100)
+	}
+	return variable()
+}
+
+# Integer expression with n operators, chained one at a time so its size grows linearly
+function expression(n,    e, ops)
+{
+	e = leaf()
+	while (n-- > 0) {
+		ops = rnd(4)
+		if (ops == 0) {
+			e = "(" e " + " leaf() ")"
+		} else if (ops == 1) {
+			e = e " - " leaf()
+		} else if (ops == 2) {
+			e = "(" e ") * " leaf()
+		} else {
+			e = e " + " leaf()
+		}
+	}
+	return e
+}
+
+# Write count statements with the given indentation; level is the current nesting
+function statements(count, indent, level,    k, r, t, l)
+{
+	t = tabs(indent)
+	for (k = 0; k < count; k++) {
+		r = rnd(100)
+		if (r < strings) {
+			print t "s = s + \"str" rnd(1000) "\" + toString(" expression(1) ");"
+		} else if (level < nesting && r < strings + 10) {
+			print t "if (" variable() " < " rnd(100) ")"
+			print t "{"
+			statements(3, indent + 1, level + 1)
+			print t "}"
+			print t "else"
+			print t "{"
+			statements(2, indent + 1, level + 1)
+			print t "}"
+		} else if (level < nesting && r < strings + 15) {
+			l = ++loops
+			print t "int i" l " = 0;"
+			print t "while (i" l " < " (1 + rnd(10)) ")"
+			print t "{"
+			statements(3, indent + 1, level + 1)
+			print t "\ti" l " = i" l " + 1;"
+			print t "}"
+		} else {
+			print t variable() " = " expression(depth) ";"
+		}
+	}
+}
+
+BEGIN {
+	srand(seed)
+	for (j = 0; j < idents; j++) {
+		print "int g" j ";"
+	}
+	print ""
+	for (f = 0; f < functions; f++) {
+		loops = 0
+		print "int f" f "(int a)"
+		print "{"
+		for (j = 0; j < idents; j++) {
+			print "\tint v" j " = a + " j ";"
+		}
+		print "\tstring s = \"f" f "\";"
+		statements(body, 1, 0)
+		if (f > 0) {
+			print "\tg0 = g0 + f" (f - 1) "(v0);"
+		}
+		print "\tprint(s);"
+		print "\treturn " expression(depth) ";"
+		print "}"
+		print ""
+	}
+	print "void main()"
+	print "{"
+	print "\tprint(toString(f" (functions - 1) "(1)));"
+	print "}"
+}'
@@ -0,0 +1,72 @@
+#!/bin/bash
+# Differential test of the two scanners. Builds of lpc with LEXER=flex and with
+# LEXER=hand must give exactly the same tokens, with the same lines, columns and
+# values, and the same errors for unknown characters. Both compilers list the
+# tokens of every example, of a set of corner cases and of random sources
+# (--dump-tokens), and the lists are compared.
+#
+# Usage: lexdiff.sh <lpc built with flex> <lpc built with the hand written lexer> [random sources]
+
+LPC_FLEX=$1
+LPC_HAND=$2
+RANDOM_SOURCES=${3:-200}
+
+if [ ! -x "$LPC_FLEX" ] || [ ! -x "$LPC_HAND" ]; then
+	echo "Usage: $0 <lpc built with flex> <lpc built with the hand written lexer> [random sources]"
+	exit 1
+fi
+
+EXAMPLES=`dirname $0`/../examples
+DIR=`mktemp -d`
+
+# Corner cases: keywords inside identifiers, numbers next to dots and letters,
+# strings with newlines and unclosed quotes, operators that only exist doubled,
+# comments at the end of the file, tabs, carriage returns and 8 bit characters
+printf 'int integer int1 _a_b __ a_ if iff else while returned string strings void bool true false truex\n' > $DIR/keywords.lp
+printf '0 007 12abc 1. 1.5 1.5.3 .5 3.x 99999999999 1.0000001 2147483648\n' > $DIR/numbers.lp
+printf 'string s = "a\nb { ; }\n\n c";\nint x = 1; "" "\\" x\n"unclosed\n' > $DIR/strings.lp
+printf '! != = == === < <= > >= | || ||| & && &&& * / + - , ; ( ) { } /**/ / / // x\n' > $DIR/operators.lp
+printf 'int x; // comment at the end without newline' > $DIR/comment.lp
+printf 'int\tx\t=\t1;\r\nint y = 2;\r\n\t\t\t  \t\n@ # $ %% ^ ~ ` ? : . [ ] \\ \x01 \xe1\xe9 \x7f\n' > $DIR/characters.lp
+awk 'BEGIN { for (i = 0; i < 100; i++) { for (j = 0; j < i; j++) printf " "; printf "x%d", i; for (j = 0; j < i % 7; j++) printf "\n"; for (j = 0; j < i; j++) printf "\t"; printf "\"%*s\"", i, ""; printf "//%*s\n", i, "" } }' > $DIR/blanks.lp
+
+# Random sources made of L+ fragments, with blanks of every length so that tokens
+# fall on every position of the 16 and 32 byte blocks
+awk -v n=$RANDOM_SOURCES -v dir=$DIR 'BEGIN {
+	srand(36)
+	split("int|float|string|bool|void|if|else|while|return|true|false|x|_y|abc1|12|3.25|7.|\"s\"|\"a\nb\"|\"|//c\n|!|!=|=|==|<|<=|>|>=|||||&|&&|*|/|+|-|,|;|(|)|{|}|\r|@|.", parts, "|")
+	count = 0
+	for (k in parts) count++
+	for (f = 0; f < n; f++) {
+		file = dir "/random" f ".lp"
+		tokens = int(rand() * 400)
+		for (t = 0; t < tokens; t++) {
+			printf "%s", parts[int(rand() * count) + 1] > file
+			blank = int(rand() * 40)
+			for (b = 0; b < blank; b++) {
+				r = rand()
+				printf "%s", (r < 0.6) ? " " : (r < 0.8) ? "\t" : "\n" > file
+			}
+		}
+		close(file)
+	}
+}'
+
+failures=0
+files=0
+for f in $EXAMPLES/*.lp $DIR/*.lp; do
+	"$LPC_FLEX" --dump-tokens "$f" > $DIR/flex.txt 2>&1
+	"$LPC_HAND" --dump-tokens "$f" > $DIR/hand.txt 2>&1
+	files=$((files + 1))
+	if ! cmp -s $DIR/flex.txt $DIR/hand.txt; then
+		echo "Different tokens for $f:"
+		diff $DIR/flex.txt $DIR/hand.txt | head -10
+		failures=$((failures + 1))
+	fi
+done
+
+rm -rf $DIR
+echo "$files sources, $failures with different tokens"
+if [ $failures -ne 0 ]; then
+	exit 1
+fi
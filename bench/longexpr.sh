@@ -0,0 +1,56 @@
+#!/bin/bash
+# Measures how the compile time of lpc grows with the length of an expression.
+# Each program adds up N variables in a single expression: with linear type
+# checking, doubling N should roughly double the time.
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+
+# Sizes to measure, can be given as arguments
+SIZES="$@"
+if [ "$SIZES" == "" ]; then
+	SIZES="500 1000 2000 4000 8000"
+fi
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+# Write an L+ program whose main has an N term expression
+function generate
+{
+	echo "void main()"
+	echo "{"
+	echo "	int x = 1;"
+	echo -n "	int y = x"
+	for ((i = 1; i < $1; i++)); do
+		echo -n " + x"
+	done
+	echo ";"
+	echo "	print(toString(y));"
+	echo "}"
+}
+
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+
+echo "terms	seconds"
+for n in $SIZES; do
+	generate $n > $DIR/long$n.lp
+	START=`date +%s.%N`
+	(cd $DIR && "$LPC" long$n.lp > /dev/null)
+	if [ $? -ne 0 ]; then
+		echo "lpc failed compiling a $n term expression, aborting..."
+		rm -rf $DIR
+		exit 1
+	fi
+	END=`date +%s.%N`
+	awk -v n=$n -v s=$START -v e=$END 'BEGIN { printf "%d\t%.3f\n", n, e - s }'
+done
+
+rm -rf $DIR
@@ -0,0 +1,93 @@
+#!/bin/bash
+# Output speed of the generated programs. An L+ program prints N lines (10
+# million by default), half of them numbers and half strings. It is compiled
+# twice: with the default buffered output and with --unbuffered-output, where
+# every print goes straight to System.out, which flushes on each line. Both
+# programs are assembled with Jasmin and run with the output sent to /dev/null.
+# Each time is the best of a few runs.
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+
+# Number of lines to print, can be given as an argument
+LINES=${1:-10000000}
+RUNS=${RUNS:-3}
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+JASMIN=$LPC_HOME/bin/jasmin.jar
+if [ ! -f "$JASMIN" ]; then
+	JASMIN=`dirname $0`/../bin/jasmin.jar
+fi
+
+if [ "`which java`" == "" ]; then
+	echo "Could not find the Java Runtime (java). Aborting..."
+	exit 1
+fi
+
+# Write an L+ program that prints N lines
+function generate
+{
+	echo "void main()"
+	echo "{"
+	echo "	int i = 0;"
+	echo "	while (i < $1)"
+	echo "	{"
+	echo "		print(i);"
+	echo "		print(\"line\");"
+	echo "		i = i + 2;"
+	echo "	}"
+	echo "}"
+}
+
+# Compile and assemble the program in directory $1, with the options that follow
+function build
+{
+	dir=$1
+	shift
+	mkdir -p $dir
+	cp "$STDLIB" $dir/
+	generate $LINES > $dir/lines.lp
+	(cd $dir && "$LPC" "$@" lines.lp > /dev/null && java -jar "$JASMIN" compopt.j > /dev/null)
+	if [ $? -ne 0 ]; then
+		echo "Could not build the program, aborting..." >&2
+		exit 1
+	fi
+}
+
+# Best wall time of RUNS runs of the program in directory $1, in milliseconds
+function best
+{
+	min=0
+	for r in `seq $RUNS`; do
+		start=`date +%s%N`
+		(cd $1 && java Main > /dev/null)
+		end=`date +%s%N`
+		t=$(((end - start) / 1000000))
+		if [ $min -eq 0 ] || [ $t -lt $min ]; then
+			min=$t
+		fi
+	done
+	echo $min
+}
+
+DIR=`mktemp -d`
+build $DIR/buffered || exit 1
+build $DIR/unbuffered --unbuffered-output || exit 1
+
+lines=`cd $DIR/buffered && java Main | wc -l`
+buffered=`best $DIR/buffered`
+unbuffered=`best $DIR/unbuffered`
+
+echo "lines:              $lines"
+echo "buffered:           $buffered ms"
+echo "unbuffered:         $unbuffered ms"
+
+rm -rf $DIR
@@ -0,0 +1,70 @@
+#!/bin/bash
+# Check of --remarks. Every example, every kernel and a set of corner cases are
+# compiled with and without --remarks: the exit status and the generated code
+# must be the same, since the remarks only describe what the passes did. The
+# corner cases fold values that have no exact literal (a float like 1/3, a string
+# with a newline), which the fold pass leaves alone and must report as
+# NotRepresentable instead of crashing.
+#
+# Usage: remarks.sh [lpc]
+
+LPC=${1:-${LPC:-$LPC_HOME/bin/lpc}}
+
+if [ ! -x "$LPC" ]; then
+	echo "Usage: $0 <lpc>"
+	exit 1
+fi
+# Absolute path, lpc runs inside the temporary directory
+LPC=`cd \`dirname "$LPC"\` && pwd`/`basename "$LPC"`
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+BENCH=`cd \`dirname $0\` && pwd`
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+
+# Corner cases: constants and calls to pure functions whose value is not representable
+printf 'void main()\n{\n\tfloat y = 1.0 / 3;\n\tprint(y);\n}\n' > $DIR/floatdiv.lp
+printf 'float third()\n{\n\treturn 1.0 / 3;\n}\n\nvoid main()\n{\n\tprint(third());\n}\n' > $DIR/floatcall.lp
+printf 'void main()\n{\n\tstring s = "a\nb" + "c";\n\tprint(s);\n}\n' > $DIR/newline.lp
+
+# Remark every corner case must have
+function expected
+{
+	case $1 in
+		floatdiv|floatcall|newline) echo NotRepresentable;;
+	esac
+}
+
+failures=0
+files=0
+for f in $BENCH/../examples/*.lp $BENCH/kernels/*.lp $DIR/*.lp; do
+	name=`basename $f .lp`
+	files=$((files + 1))
+	(cd $DIR && "$LPC" -O3 --filter $f > plain.j 2> /dev/null) 2> /dev/null
+	plain=$?
+	(cd $DIR && "$LPC" -O3 --filter --remarks=remarks.yaml $f > remarks.j 2> /dev/null) 2> /dev/null
+	result=$?
+
+	if [ $plain -ne $result ]; then
+		echo "$name: exit status $plain without --remarks, $result with it"
+		failures=$((failures + 1))
+	elif ! cmp -s $DIR/plain.j $DIR/remarks.j; then
+		echo "$name: --remarks changes the generated code"
+		diff $DIR/plain.j $DIR/remarks.j | head -10
+		failures=$((failures + 1))
+	elif [ -n "`expected $name`" ] && ! grep -q "^Name: *`expected $name`$" $DIR/remarks.yaml; then
+		echo "$name: no `expected $name` remark"
+		failures=$((failures + 1))
+	fi
+	rm -f $DIR/remarks.yaml
+done
+
+rm -rf $DIR
+echo "$files sources, $failures failed"
+if [ $failures -ne 0 ]; then
+	exit 1
+fi
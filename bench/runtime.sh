@@ -0,0 +1,205 @@
+#!/bin/bash
+# Run time and differential check of the generated code. Every program of the
+# corpus (examples/ and the kernels in bench/kernels/) is compiled with each
+# setting of SETTINGS, assembled with Jasmin and run on the local JVM with a
+# fixed input. The output and exit status of every setting must be the same as
+# the ones of the first setting, the least optimized; any difference is reported
+# and makes the script fail, so a new optimization must pass it before it is
+# merged. Programs the first setting cannot compile (the examples with errors on
+# purpose) are skipped.
+#
+# For each program and setting the script records the number of instructions of
+# the user code, the size of Main.class, the best run time of RUNS runs and the
+# bytes allocated by the program. The allocations are measured in another run
+# with the Epsilon GC (JDK 11 or later), which never frees memory, so the heap
+# used at exit is what the program and the JVM startup allocated; they are null
+# with an older JVM or if the program needs more than ALLOC_HEAP. The results are
+# saved as JSON, one point per line, with the speedup over the first setting.
+#
+# Usage: runtime.sh [results.json]
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+OUT=${1:-runtime.json}
+RUNS=${RUNS:-3}
+TIMEOUT=${TIMEOUT:-60}
+ALLOC_HEAP=${ALLOC_HEAP:-4g}
+JAVA=${JAVA:-java}
+
+# Settings: name, file with the code to run and options of lpc separated by '+'.
+# The first one is the reference the others are compared to.
+SETTINGS=${SETTINGS:-"O0:compopt.j:-O0 O1:compopt.j:-O1 O2:compopt.j:-O2 O3:compopt.j:-O3 stream:compopt.j:-O2+--stream"}
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+# Absolute path, lpc runs inside the temporary directory
+LPC=`cd \`dirname "$LPC"\` && pwd`/`basename "$LPC"`
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+JASMIN=$LPC_HOME/bin/jasmin.jar
+if [ ! -f "$JASMIN" ]; then
+	JASMIN=`dirname $0`/../bin/jasmin.jar
+fi
+JASMIN=`cd \`dirname "$JASMIN"\` && pwd`/`basename "$JASMIN"`
+
+if ! $JAVA -version > /dev/null 2>&1; then
+	echo "Could not find the Java Runtime ($JAVA). Please set JAVA. Aborting..."
+	exit 1
+fi
+
+# Fixed input of each program
+function input
+{
+	case $1 in
+		fibo)		echo 20;;
+		read)		echo "Hello from the benchmark";;
+		recursion)	echo "32 2000";;
+		loops)		echo 100000;;
+		strings)	echo 50000;;
+		io)		awk 'BEGIN {
+					srand(1)
+					n = 200000
+					print n
+					for (i = 0; i < n; i++) {
+						printf "%d%s", int(rand() * 100000), (i % 10 == 9) ? "\n" : " "
+					}
+					print "3.25"
+					print "the rest of the input"
+					print "in two lines"
+				}';;
+	esac
+}
+
+# Number of instructions of the user code in a Jasmin file
+function instructions
+{
+	awk '/^; Codigo de usuario/ { user = 1 } user && /^\t[a-z]/ { n++ } END { print n + 0 }' $1
+}
+
+# Kilobytes of heap used at exit in an Epsilon GC log, empty if it is not there
+function allocated
+{
+	sed -n 's/.*committed, \([0-9]*\)\([BKMG]\) .*used.*/\1 \2/p' $1 | tail -1 | awk '{
+		if ($2 == "B") print int($1 / 1024); else if ($2 == "K") print $1;
+		else if ($2 == "M") print $1 * 1024; else print $1 * 1024 * 1024 }'
+}
+
+DIR=`mktemp -d`
+BENCH=`cd \`dirname $0\` && pwd`
+PROGRAMS="`ls $BENCH/../examples/*.lp $BENCH/kernels/*.lp`"
+
+printf "%-14s %-10s %-14s %8s %8s %10s %12s %8s\n" program setting status instrs "class B" "time (ms)" "alloc KB" speedup
+
+failures=0
+for program in $PROGRAMS; do
+	name=`basename $program .lp`
+	input $name > $DIR/$name.in
+	reference=""
+	for setting in $SETTINGS; do
+		sname=`echo $setting | cut -d: -f1`
+		code=`echo $setting | cut -d: -f2`
+		options=`echo $setting | cut -d: -f3 | tr '+' ' '`
+		work=$DIR/$sname/$name
+		mkdir -p $work
+		cp "$STDLIB" $program $work/
+
+		status=ok
+		instrs=null
+		bytes=null
+		time=null
+		alloc=null
+		(cd $work && "$LPC" --emit=asm,opt-asm $options $name.lp > compile.txt 2>&1) 2> /dev/null
+		if [ $? -ne 0 ] || [ ! -f $work/$code ]; then
+			status=compile_error
+		elif ! (cd $work && $JAVA -jar "$JASMIN" $code > jasmin.txt 2>&1) || [ ! -f $work/Main.class ]; then
+			status=assemble_error
+		else
+			instrs=`instructions $work/$code`
+			bytes=`wc -c < $work/Main.class`
+
+			best=0
+			for r in `seq $RUNS`; do
+				start=`date +%s%N`
+				(cd $work && timeout $TIMEOUT $JAVA -cp . Main < $DIR/$name.in > out.txt 2> err.txt)
+				result=$?
+				end=`date +%s%N`
+				t=$(((end - start) / 1000))
+				if [ $best -eq 0 ] || [ $t -lt $best ]; then
+					best=$t
+				fi
+			done
+			time=`awk -v t=$best 'BEGIN { printf "%.1f", t / 1000 }'`
+			echo "exit status $result" >> $work/out.txt
+			if [ $result -eq 124 ]; then
+				status=timeout
+			fi
+
+			(cd $work && timeout $TIMEOUT $JAVA -XX:+UnlockExperimentalVMOptions -XX:+UseEpsilonGC -XX:-UseTLAB \
+				-Xms$ALLOC_HEAP -Xmx$ALLOC_HEAP -Xlog:gc:file=gc.log -cp . Main < $DIR/$name.in > /dev/null 2>&1)
+			if [ $? -eq 0 ] && [ -f $work/gc.log ]; then
+				alloc=`allocated $work/gc.log`
+				alloc=${alloc:-null}
+			fi
+		fi
+
+		# The first setting is the reference: skip the programs it cannot run
+		if [ "$reference" == "" ]; then
+			if [ $status != ok ]; then
+				printf "%-14s %-10s %s\n" $name $sname "skipped ($status)"
+				break
+			fi
+			reference=$work
+			referenceTime=$time
+		elif [ $status == ok ] && ! cmp -s $reference/out.txt $work/out.txt; then
+			status=mismatch
+		fi
+		if [ $status != ok ]; then
+			failures=$((failures + 1))
+		fi
+
+		speedup=null
+		if [ $time != null ]; then
+			speedup=`awk -v r=$referenceTime -v t=$time 'BEGIN { printf "%.2f", (t > 0) ? r / t : 0 }'`
+		fi
+		printf "%-14s %-10s %-14s %8s %8s %10s %12s %8s\n" $name $sname $status $instrs $bytes $time $alloc $speedup
+		echo -e "$name\t$sname\t$status\t$instrs\t$bytes\t$time\t$alloc\t$speedup" >> $DIR/results.tsv
+		if [ $status == mismatch ]; then
+			diff $reference/out.txt $work/out.txt | head -10
+		fi
+	done
+done
+
+# Geometric mean of the speedups of each setting over the programs that passed
+echo
+awk -F'\t' '$3 == "ok" && $8 > 0 { sum[$2] += log($8); n[$2]++; if (!($2 in seen)) { seen[$2] = 1; order[++k] = $2 } }
+	END { for (i = 1; i <= k; i++) printf "%-10s geometric mean speedup %.2f over %d programs\n", order[i], exp(sum[order[i]] / n[order[i]]), n[order[i]] }' $DIR/results.tsv
+
+commit=`cd $BENCH && git rev-parse --short HEAD 2> /dev/null`
+java=`$JAVA -version 2>&1 | head -1 | sed 's/"/\\\\"/g'`
+{
+	echo "{"
+	echo "  \"commit\": \"$commit\","
+	echo "  \"date\": \"`date -u +%Y-%m-%dT%H:%M:%SZ`\","
+	echo "  \"java\": \"$java\","
+	echo "  \"settings\": \"$SETTINGS\","
+	echo "  \"failures\": $failures,"
+	echo "  \"points\": ["
+	awk -F'\t' '{ printf "%s    {\"program\": \"%s\", \"setting\": \"%s\", \"status\": \"%s\", \"instructions\": %s, \"class_bytes\": %s, \"run_ms\": %s, \"allocated_kb\": %s, \"speedup\": %s}",
+		(NR > 1) ? ",\n" : "", $1, $2, $3, $4, $5, $6, $7, $8 }' $DIR/results.tsv
+	echo
+	echo "  ]"
+	echo "}"
+} > "$OUT"
+echo "Results saved as $OUT"
+
+rm -rf $DIR
+
+if [ $failures -ne 0 ]; then
+	echo "$failures runs failed or differ from the reference"
+	exit 1
+fi
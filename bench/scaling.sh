@@ -0,0 +1,149 @@
+#!/bin/bash
+# Compile throughput and scaling of lpc over programs from genprog.sh. Each knob
+# of the generator (functions, body length, expression depth, identifiers,
+# nesting and string density) is doubled STEPS times from its base value while
+# the others stay at theirs, and every program is compiled with --filter (code
+# sent to /dev/null) and --stats-json. For each program the script reports the
+# lines per second, the peak memory and the growth exponent of the compile time
+# against the size of the source in bytes (deeper expressions do not add lines)
+# since the previous step: about 1 is linear, 2 is quadratic. Steps above LIMIT are marked, they usually come from linear scans
+# such as the ones of the symbol table. Each time is the best of RUNS runs.
+#
+# The results are saved as JSON, one point per line, to compare them across
+# commits: with a previous results file as second argument, the time of each
+# point is also shown relative to it.
+#
+# Usage: scaling.sh [results.json] [baseline.json]
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+OUT=${1:-scaling.json}
+BASELINE=$2
+STEPS=${STEPS:-5}
+RUNS=${RUNS:-3}
+LIMIT=${LIMIT:-1.5}
+
+# Knobs: option of genprog.sh, name and base value
+KNOBS="f:functions:100 b:body:20 d:depth:4 i:identifiers:8 n:nesting:1 s:strings:5"
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+# Absolute path, lpc runs inside the temporary directory
+LPC=`cd \`dirname "$LPC"\` && pwd`/`basename "$LPC"`
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+GENERATOR=`dirname $0`/genprog.sh
+
+if [ "$BASELINE" != "" ] && [ ! -f "$BASELINE" ]; then
+	echo "Could not find baseline results: $BASELINE. Aborting..."
+	exit 1
+fi
+
+# Value of a number field of a JSON line: field name file
+function field
+{
+	grep "\"$1\"" $2 | head -1 | sed "s/.*\"$1\": *\([0-9.]*\).*/\1/"
+}
+
+# Compile the program in $DIR/prog.lp RUNS times, keep the statistics of the fastest run
+function measure
+{
+	best=0
+	for r in `seq $RUNS`; do
+		(cd $DIR && "$LPC" --filter --stats-json=run.json prog.lp > /dev/null 2>&1)
+		if [ $? -ne 0 ]; then
+			echo "lpc failed compiling $1, aborting..." >&2
+			return 1
+		fi
+		t=`grep '"total"' $DIR/run.json | sed 's/.*"wall_ms": *\([0-9.]*\).*/\1/'`
+		if [ $best == 0 ] || awk -v t=$t -v b=$best 'BEGIN { exit !(t < b) }'; then
+			best=$t
+			cp $DIR/run.json $DIR/best.json
+		fi
+	done
+}
+
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+
+commit=`cd \`dirname $0\` && git rev-parse --short HEAD 2> /dev/null`
+{
+	echo "{"
+	echo "  \"commit\": \"$commit\","
+	echo "  \"date\": \"`date -u +%Y-%m-%dT%H:%M:%SZ`\","
+	echo "  \"steps\": $STEPS,"
+	echo "  \"points\": ["
+} > $DIR/results.json
+
+printf "%-12s %6s %8s %9s %10s %12s %10s %9s" knob value lines bytes "time (ms)" "lines/s" "peak KB" exponent
+if [ "$BASELINE" != "" ]; then
+	printf " %9s" baseline
+fi
+echo
+
+first=1
+flagged=0
+for knob in $KNOBS; do
+	option=`echo $knob | cut -d: -f1`
+	name=`echo $knob | cut -d: -f2`
+	value=`echo $knob | cut -d: -f3`
+	lastBytes=0
+	lastTime=0
+	for step in `seq $STEPS`; do
+		bash $GENERATOR -$option $value > $DIR/prog.lp
+		lines=`wc -l < $DIR/prog.lp`
+		bytes=`wc -c < $DIR/prog.lp`
+		measure "$name=$value" || { rm -rf $DIR; exit 1; }
+		time=`grep '"total"' $DIR/best.json | sed 's/.*"wall_ms": *\([0-9.]*\).*/\1/'`
+		peak=`field peak_rss_kb $DIR/best.json`
+		speed=`awk -v l=$lines -v t=$time 'BEGIN { printf "%d", (t > 0) ? l * 1000 / t : 0 }'`
+		exponent=`awk -v b=$bytes -v t=$time -v pb=$lastBytes -v pt=$lastTime 'BEGIN {
+			if (pb > 0 && pt > 0 && b > pb * 1.1 && t > 0) printf "%.2f", log(t / pt) / log(b / pb); else printf "null" }'`
+
+		mark=""
+		if [ $exponent != null ] && awk -v e=$exponent -v m=$LIMIT 'BEGIN { exit !(e > m) }'; then
+			mark=" <-- superlinear"
+			flagged=$((flagged + 1))
+		fi
+
+		relative="null"
+		if [ "$BASELINE" != "" ]; then
+			old=`grep "\"knob\": \"$name\", \"value\": $value," $BASELINE | sed 's/.*"wall_ms": *\([0-9.]*\).*/\1/'`
+			if [ "$old" != "" ]; then
+				relative=`awk -v t=$time -v o=$old 'BEGIN { printf "%.2f", (o > 0) ? t / o : 0 }'`
+			fi
+		fi
+
+		printf "%-12s %6d %8d %9d %10.1f %12d %10d %9s" $name $value $lines $bytes $time $speed $peak $exponent
+		if [ "$BASELINE" != "" ]; then
+			printf " %8sx" $relative
+		fi
+		echo "$mark"
+
+		if [ $first == 0 ]; then
+			echo "," >> $DIR/results.json
+		fi
+		first=0
+		echo -n "    {\"knob\": \"$name\", \"value\": $value, \"lines\": $lines, \"bytes\": $bytes, \"wall_ms\": $time, \"lines_per_s\": $speed, \"peak_rss_kb\": $peak, \"exponent\": $exponent, \"baseline_ratio\": $relative}" >> $DIR/results.json
+
+		lastBytes=$bytes
+		lastTime=$time
+		value=$((value * 2))
+	done
+done
+
+{
+	echo
+	echo "  ],"
+	echo "  \"superlinear_steps\": $flagged"
+	echo "}"
+} >> $DIR/results.json
+cp $DIR/results.json "$OUT"
+echo "Results saved as $OUT"
+
+rm -rf $DIR
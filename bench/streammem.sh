@@ -0,0 +1,88 @@
+#!/bin/bash
+# Peak memory of lpc with and without --stream. Each program has N functions of
+# the same size: compiling the whole source at once needs memory for all of
+# them, while --stream should stay flat no matter how many functions there are.
+# Peak resident memory is taken from VmHWM in /proc while lpc runs.
+
+LPC=${LPC:-$LPC_HOME/bin/lpc}
+
+# Number of functions to test, can be given as arguments
+SIZES="$@"
+if [ "$SIZES" == "" ]; then
+	SIZES="1000 10000 100000"
+fi
+
+if [ ! -x "$LPC" ]; then
+	echo "Could not find compiler executable ($LPC). Please set LPC or LPC_HOME. Aborting..."
+	exit 1
+fi
+
+STDLIB=$LPC_HOME/lib/lpstdlib.j
+if [ ! -f "$STDLIB" ]; then
+	STDLIB=`dirname $0`/../bin/lpstdlib.j
+fi
+
+# Write an L+ program with N functions, each one with a loop and a few locals
+function generate
+{
+	awk -v n=$1 'BEGIN {
+		print "int total;"
+		for (i = 0; i < n; i++) {
+			print "int f" i "(int x, float y)"
+			print "{"
+			print "\tint i = 0;"
+			print "\tint a = x * " i " + 1;"
+			print "\tfloat b = y / 2.5 + a;"
+			print "\twhile (i < x)"
+			print "\t{"
+			print "\t\ta = a + i * (x - 1) + " i ";"
+			print "\t\tif (a > 1000) { a = a - 1000; } else { b = b + 1.5; }"
+			print "\t\ti = i + 1;"
+			print "\t}"
+			print "\ttotal = total + a;"
+			print "\tprint(\"f" i ": \" + toString(b));"
+			print "\treturn a;"
+			print "}"
+		}
+		print "void main()"
+		print "{"
+		print "\tint r = f" (n - 1) "(3, 1.0);"
+		print "\tprint(toString(r));"
+		print "}"
+	}'
+}
+
+# Run lpc and print its peak resident memory in KB
+function peak
+{
+	(cd $DIR && exec "$LPC" "$@" > /dev/null) &
+	pid=$!
+	hwm=0
+	while [ -e /proc/$pid/status ]; do
+		h=`awk '/VmHWM/ { print $2 }' /proc/$pid/status 2> /dev/null`
+		if [ "$h" != "" ]; then
+			hwm=$h
+		fi
+		sleep 0.01
+	done
+	wait $pid
+	if [ $? -ne 0 ]; then
+		echo "lpc failed, aborting..." >&2
+		exit 1
+	fi
+	echo $hwm
+}
+
+DIR=`mktemp -d`
+cp "$STDLIB" $DIR/
+
+echo "functions	source KB	whole KB	stream KB"
+for n in $SIZES; do
+	generate $n > $DIR/funcs$n.lp
+	size=$((`wc -c < $DIR/funcs$n.lp` / 1024))
+	whole=`peak funcs$n.lp --jobs=1` || break
+	stream=`peak funcs$n.lp --stream` || break
+	echo "$n	$size	$whole	$stream"
+done
+
+rm -rf $DIR
@@ -43,12 +43,12 @@ if not exist %LPC_HOME%\bin\lpc.exe (
 if not exist %LPC_HOME%\lib\lpstdlib.j goto error
 copy %LPC_HOME%\lib\lpstdlib.j .
 
-@rem Call the compiler and assembler:
+@rem Call the compiler and assembler (the source file goes first, then any compiler options):
 echo Checking if %1 file exists...
 if not exist %1 goto error
 
 echo Invoking the lpc compiler...
-%LPC_HOME%\bin\lpc.exe %1
+%LPC_HOME%\bin\lpc.exe %*
 
 if not errorlevel 0 goto error
 
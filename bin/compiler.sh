@@ -48,22 +48,31 @@ function build
 {
 	echo "Looking for L+ source file"
 
-	if [ "$1" == "" ]; then
+	# Arguments starting with "-" are compiler options (--memoize, -O3...), the other one is the source file
+	SRC=""
+	for arg in "$@"; do
+		case "$arg" in
+			-*)	;;
+			*)	SRC="$arg";;
+		esac
+	done
+
+	if [ "$SRC" == "" ]; then
 		echo "L+ source file not specified, aborting..."
 		exit 1
 	fi
 
-	if [ ! -f "$1" ]; then
-		echo "Could not find source file: $1, aborting..."
+	if [ ! -f "$SRC" ]; then
+		echo "Could not find source file: $SRC, aborting..."
 		exit 1
 	fi
 
 	echo " "
 	echo "Starting the build process..."
 	echo "Invoking the L+ compiler..."
-	cp $LPC_HOME/lib/lpstdlib.j `dirname $1`
-	$LPC_HOME/bin/lpc "$1"
-	rm `dirname $1`/lpstdlib.j
+	cp $LPC_HOME/lib/lpstdlib.j `dirname $SRC`
+	$LPC_HOME/bin/lpc "$@"
+	rm `dirname $SRC`/lpstdlib.j
 
 	if [ $? -ne 0 ]; then
 		echo "Something went wrong compiling the file. Please check the compiler error messages."
@@ -89,6 +98,7 @@ function hlp
 {
 	echo "Usage:"
 	echo "$0 sourcecode.lp : Compile an L+ program from source."
+	echo "$0 [options] sourcecode.lp : Compile passing options to the compiler (e.g. -O3 or --memoize)."
 	echo "$0 help : Print this help message."
 	echo "$0 clean : Clean up files generated from last build."
 }
@@ -98,7 +108,7 @@ function main
 {
 	clean
 	checkfiles
-	build $1
+	build "$@"
 }
 
 # Entry point
@@ -115,7 +125,7 @@ case "$1" in
 	"clean")	clean
 		exit 0;;
 
-	*)	main $1
+	*)	main "$@"
 		exit 0;;
 esac
 hlp
@@ -17,19 +17,646 @@
  */
 
 #include "ast.h"
+#include "parallel.h"
+#include "stats.h"
+#include "trace.h"
+#include "passes.h"
+#include "remarks.h"
+#include "emitter.h"
+
+#include <pthread.h>
 
 //
 //Variables Globales
 //
 
-// Contador de etiquetas:
-int label = 0;
-//Linea actual en el fuente L+
-extern int line;
+// Contador de etiquetas, por metodo. Cada hilo compila sus propios metodos.
+__thread int label = 0;
+//Ultima linea del fuente indicada con .line en el metodo que se compila
+static __thread int lastLine = 0;
+//Funcion que se compila en el hilo actual, duena de los contadores de --instrument
+static __thread FuncDeclNode* profScope = NULL;
+//Linea actual en el fuente L+ (cada hilo que analiza una parte del fuente tiene la suya)
+extern __thread int line;
 //Nombre del archivo de entrada
 extern const char *filename;
-//Bandera que indica si el analisis semantico fue exitoso
-extern bool semantics;
+//Bandera que indica si el analisis semantico fue exitoso (en el hilo actual)
+extern __thread bool semantics;
+//Opciones de memoizacion
+extern bool memoStats;
+//print escribe directo en System.out, sin buffer propio
+extern bool unbufferedOutput;
+//Tablas de lineas y de variables locales (sin --strip-debug)
+extern bool debugInfo;
+//Contadores de llamadas y de iteraciones en el codigo generado
+extern bool instrument;
+//Fuente y fuente optimizado impresos (--emit=ast y --emit=opt-ast)
+extern bool emitAst;
+extern bool emitOptAst;
+//Declaraciones de funciones del programa, para el interprete de tiempo de compilacion
+map<string, FuncDeclNode*> funcDecls;
+
+//Salida de los mensajes de error del hilo actual. Al validar en paralelo cada funcion
+//junta los suyos aparte, para imprimirlos luego en el orden del fuente.
+static __thread ostream* errOut = NULL;
+
+static ostream& errors()
+{
+	return (errOut != NULL) ? *errOut : cout;
+}
+
+//Funcion que se esta optimizando o compilando en el hilo actual, para las observaciones de --remarks
+static __thread FuncDeclNode* remarkScope = NULL;
+
+/** Registra una observacion de --remarks de una pasada sobre la funcion actual. **/
+static void remark(ERemarkKind kind, EPass pass, const char* name, int line, const string& message)
+{
+	remarks.add(kind, passes.getName(pass), name, (remarkScope != NULL) ? remarkScope->getId() : string(), line, message);
+}
+
+/** Fuente de un nodo en una sola linea y abreviado, para los mensajes de --remarks. **/
+static string remarkText(Node* node)
+{
+	ostringstream printed;
+	node->prettyPrint(printed, 0);
+	string source = printed.str();
+	string text;
+	for (unsigned int i = 0; i < source.size(); i++)
+	{
+		char c = (source[i] == '\n' || source[i] == '\t') ? ' ' : source[i];
+		if (c != ' ' || (!text.empty() && text[text.size() - 1] != ' '))
+		{
+			text += c;
+		}
+	}
+	while (!text.empty() && text[text.size() - 1] == ' ')
+	{
+		text.erase(text.size() - 1);
+	}
+	if (text.size() > 60)
+	{
+		text = text.substr(0, 57) + "...";
+	}
+	return text;
+}
+
+/** Determina si la funcion target es alcanzable a traves de las llamadas de from. **/
+static bool reaches(string from, string target, set<string>& visited)
+{
+	map<string, FuncDeclNode*>::iterator it = funcDecls.find(from);
+	if (it == funcDecls.end() || visited.find(from) != visited.end())
+	{
+		return false;
+	}
+	visited.insert(from);
+	set<string>& callees = it->second->getCallees();
+	for (set<string>::iterator c = callees.begin(); c != callees.end(); c++)
+	{
+		if (*c == target || reaches(*c, target, visited))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Memoiza func si es pura y recursiva (pasada memoize). **/
+static void memoizeFunction(FuncDeclNode* func)
+{
+	set<string> visited;
+	if (func->returnsVoid() || func->getId() == "main" || !reaches(func->getId(), func->getId(), visited))
+	{
+		return;
+	}
+	remarkScope = func;
+	if (func->isPureFunction())
+	{
+		func->setMemoize(true);
+		if (remarks.isEnabled())
+		{
+			remark(RK_PASSED, PASS_MEMOIZE, "Memoized", func->getDeclLine(), func->getId() + " is pure and recursive: its results are cached");
+		}
+	}
+	else if (remarks.isEnabled())
+	{
+		remark(RK_MISSED, PASS_MEMOIZE, "NotPure", func->getDeclLine(), func->getId() + " is recursive but not memoized: it has side effects or calls a function that has them");
+	}
+	remarkScope = NULL;
+}
+
+/**
+ * Compila la directiva .line que asocia el codigo que sigue con una linea del fuente, para
+ * los perfiladores y depuradores. Se omite si el codigo anterior ya es de esa linea. Se
+ * invoca justo antes de las instrucciones de la linea, para no dejar directivas sin codigo.
+ **/
+static void compileLine(ostream& out, int l)
+{
+	if (debugInfo && l > 0 && l != lastLine)
+	{
+		out << ".line " << l << "\n";
+		lastLine = l;
+	}
+}
+
+/** Compila el vaciado del buffer de print, que solo se escribe al llenarse. **/
+static void compileFlushOutput(ostream& out)
+{
+	if (!unbufferedOutput)
+	{
+		out << "\tgetstatic " << className << "/print__out Ljava/io/PrintStream;\n";
+		out << "\tinvokevirtual java/io/PrintStream/flush()V\n";
+	}
+}
+
+/** Compila la escritura del perfil de --instrument. **/
+static void compileProfileDump(ostream& out)
+{
+	if (instrument)
+	{
+		out << "\tinvokestatic " << className << "/prof__dump()V\n";
+	}
+}
+
+/** Compila el codigo a ejecutar cuando termina main. **/
+static void compileExitHooks(ostream& out)
+{
+	if (memoStats)
+	{
+		for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+		{
+			it->second->compileMemoStats(out);
+		}
+	}
+	compileProfileDump(out);
+	compileFlushOutput(out);
+}
+
+/** Compila la creacion del stream de print (print__out en lpstdlib.j). **/
+static void compileOutputInit(ostream& out)
+{
+	if (unbufferedOutput)
+	{
+		out << "\tgetstatic java/lang/System/out Ljava/io/PrintStream;\n";
+	}
+	else
+	{
+		//En una consola se usa System.out, que escribe cada linea (como stdout en C), para que
+		//los mensajes aparezcan antes de leer la respuesta
+		out << "\tinvokestatic java/lang/System/console()Ljava/io/Console;\n";
+		out << "\tifnull Label0\n";
+		out << "\tgetstatic java/lang/System/out Ljava/io/PrintStream;\n";
+		out << "\tgoto Label1\n";
+		//Si no, new PrintStream(new BufferedOutputStream(new FileOutputStream(FileDescriptor.out), 64K), false):
+		//sin autoflush, cada print no es una llamada al sistema
+		out << "Label0:\n";
+		out << "\tnew java/io/PrintStream\n";
+		out << "\tdup\n";
+		out << "\tnew java/io/BufferedOutputStream\n";
+		out << "\tdup\n";
+		out << "\tnew java/io/FileOutputStream\n";
+		out << "\tdup\n";
+		out << "\tgetstatic java/io/FileDescriptor/out Ljava/io/FileDescriptor;\n";
+		out << "\tinvokespecial java/io/FileOutputStream/<init>(Ljava/io/FileDescriptor;)V\n";
+		out << "\tldc " << outputBufferSize << "\n";
+		out << "\tinvokespecial java/io/BufferedOutputStream/<init>(Ljava/io/OutputStream;I)V\n";
+		out << "\ticonst_0\n";
+		out << "\tinvokespecial java/io/PrintStream/<init>(Ljava/io/OutputStream;Z)V\n";
+		out << "Label1:\n";
+	}
+	out << "\tputstatic " << className << "/print__out Ljava/io/PrintStream;\n";
+}
+
+/** Compila el inicializador estatico de la clase (stream de print y caches de memoizacion). **/
+static void compileClassInit(ostream& out)
+{
+	out << "\n.method static <clinit>()V\n";
+	out << "\t.limit stack " << maxStack << "\n";
+	out << "\t.limit locals 0\n";
+	compileOutputInit(out);
+	for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+	{
+		it->second->compileStaticInit(out);
+	}
+	out << "\treturn\n";
+	out << ".end method\n";
+}
+
+/**
+ * Compila el metodo que escribe los contadores de --instrument en el perfil, una linea por
+ * contador: tipo (call o loop), funcion, linea y cantidad, separados por tabuladores. Se
+ * compila al final, cuando ya se conocen los ciclos de cada funcion.
+ **/
+static void compileProfileWriter(ostream& out)
+{
+	if (!instrument)
+	{
+		return;
+	}
+	out << "\n.method public static prof__dump()V\n";
+	out << "\t.limit stack " << maxStack << "\n";
+	out << "\t.limit locals 1\n";
+	out << "\tnew java/io/PrintStream\n";
+	out << "\tdup\n";
+	out << "\tldc \"" << profileFile << "\"\n";
+	out << "\tinvokespecial java/io/PrintStream/<init>(Ljava/lang/String;)V\n";
+	out << "\tastore_0\n";
+	out << "\taload_0\n";
+	out << "\tldc \"# kind\\tfunction\\tline\\tcount\"\n";
+	out << "\tinvokevirtual java/io/PrintStream/println(Ljava/lang/String;)V\n";
+	for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+	{
+		it->second->compileProfile(out);
+	}
+	out << "\taload_0\n";
+	out << "\tinvokevirtual java/io/PrintStream/close()V\n";
+	out << "\treturn\n";
+	out << ".end method\n";
+}
+
+/** Determina si una funcion predefinida no tiene efectos secundarios. **/
+static bool isPureBuiltin(string f)
+{
+	return (f == "trunc" || f == "toString" || f == "toInt");
+}
+
+/** Determina si una llamada no tiene efectos laterales (funcion predefinida o de usuario pura). **/
+static bool isPureCall(string f)
+{
+	map<string, FuncDeclNode*>::iterator it = funcDecls.find(f);
+	return isPureBuiltin(f) || (it != funcDecls.end() && it->second->isPureFunction());
+}
+
+//Cantidad de variables temporales creadas para las expresiones invariantes de los ciclos
+static int hoistedTemps = 0;
+
+//Globales promovidas del ciclo que se esta resolviendo o compilando en el hilo actual, NULL fuera de los ciclos
+static __thread list<CPromotedGlobal>* promotedGlobals = NULL;
+
+/**
+ * Guarda en los campos estaticos las globales promovidas que el ciclo modifica. Si se indica
+ * la linea, su .line se escribe antes del primer guardado, solo si el ciclo modifica alguna.
+ **/
+static void compileWriteBack(ostream& out, int line = 0)
+{
+	if (promotedGlobals == NULL)
+	{
+		return;
+	}
+	for (list<CPromotedGlobal>::iterator it = promotedGlobals->begin(); it != promotedGlobals->end(); it++)
+	{
+		if (it->written)
+		{
+			compileLine(out, line);
+			out << "\t" << util::compileLocal(it->type, "load", it->slot) << "\n";
+			out << "\tputstatic " << className << "/" << it->id << " " << util::compile(it->type) << "\n";
+		}
+	}
+}
+
+/** Vuelve a cargar las globales promovidas, luego de una llamada que pudo modificarlas. **/
+static void compileReload(ostream& out)
+{
+	if (promotedGlobals == NULL)
+	{
+		return;
+	}
+	for (list<CPromotedGlobal>::iterator it = promotedGlobals->begin(); it != promotedGlobals->end(); it++)
+	{
+		out << "\tgetstatic " << className << "/" << it->id << " " << util::compile(it->type) << "\n";
+		out << "\t" << util::compileLocal(it->type, "store", it->slot) << "\n";
+	}
+}
+
+/** 
+ * Construye la constante que representa un valor calculado en tiempo de compilacion.
+ * Devuelve NULL si el valor no se puede representar como literal sin perder informacion.
+ **/
+static Exp* literalValue(CValue& v)
+{
+	switch (v.tipo)
+	{
+		case ET_INT: return new IntConst(v.i);
+		case ET_BOOL: return new BoolConst(v.b);
+		case ET_FLOAT:
+		{
+			//FloatConst se compila con la precision por defecto de ostream
+			ostringstream os;
+			os << v.f;
+			string s = os.str();
+			if (s.find_first_not_of("-0123456789.") != string::npos || strtof(s.c_str(), NULL) != v.f)
+			{
+				return NULL;
+			}
+			return new FloatConst(v.f);
+		}
+		case ET_STRING:
+		{
+			//Jasmin interpreta las secuencias de escape
+			if (v.s.find_first_of("\"\\\n") != string::npos)
+			{
+				return NULL;
+			}
+			return new StringConst("\"" + v.s + "\"");
+		}
+		default: return NULL;
+	}
+}
+
+/** Literal con el valor v en la linea l, la de la expresion a la que sustituye. **/
+static Exp* literal(CValue& v, int l)
+{
+	Exp* e = literalValue(v);
+	if (e != NULL)
+	{
+		e->setLine(l);
+	}
+	return e;
+}
+
+//
+//Recorridos sin recursion de las expresiones (ver Exp::walk)
+//
+
+/** Calcula los tipos que faltan, de los operandos hacia la raiz. **/
+class CTypeVisitor : public CExpVisitor
+{
+	private:
+		CPilaDeSimbolos& stack;
+		CFunctionTable& functable;
+	public:
+		CTypeVisitor(CPilaDeSimbolos& s, CFunctionTable& f) : stack(s), functable(f) {}
+		bool enter(Exp* e) { return !e->typeResolved; }
+		void leave(Exp* e)
+		{
+			e->cachedType = e->computeType(stack, functable);
+			e->typeResolved = true;
+		}
+};
+
+/** Imprime la expresion. **/
+class CPrintVisitor : public CExpVisitor
+{
+	private:
+		ostream& out;
+		int depth;
+		//Llamadas abiertas; sus argumentos se imprimen sin identacion
+		int calls;
+	public:
+		CPrintVisitor(ostream& o, int d) : out(o), depth(d), calls(0) {}
+		bool enter(Exp* e)
+		{
+			e->prettyPrintPart(out, (calls > 0) ? 0 : depth, 0);
+			if (dynamic_cast<FCallNode*>(e) != NULL)
+			{
+				calls++;
+			}
+			return true;
+		}
+		void between(Exp* e, int i) { e->prettyPrintPart(out, depth, i); }
+		void leave(Exp* e)
+		{
+			if (dynamic_cast<FCallNode*>(e) != NULL)
+			{
+				calls--;
+			}
+			if (e->getOperandCount() > 0)
+			{
+				e->prettyPrintPart(out, depth, e->getOperandCount());
+			}
+		}
+};
+
+/** Compila la expresion. **/
+class CCompileVisitor : public CExpVisitor
+{
+	private:
+		ostream& out;
+		CFunctionTable& functable;
+	public:
+		CCompileVisitor(ostream& o, CFunctionTable& f) : out(o), functable(f) {}
+		bool enter(Exp* e) { e->compilePart(out, functable, 0); return true; }
+		void between(Exp* e, int i) { e->compilePart(out, functable, i); }
+		void leave(Exp* e)
+		{
+			if (e->getOperandCount() > 0)
+			{
+				e->compilePart(out, functable, e->getOperandCount());
+			}
+		}
+};
+
+/** Valida cada nodo luego de sus operandos. **/
+class CCheckVisitor : public CExpVisitor
+{
+	private:
+		CPilaDeSimbolos& stack;
+		CFunctionTable& functable;
+	public:
+		CCheckVisitor(CPilaDeSimbolos& s, CFunctionTable& f) : stack(s), functable(f) {}
+		void leave(Exp* e) { e->checkNode(stack, functable); }
+};
+
+/** Sustituye cada operando por su version optimizada. La raiz la sustituye quien la contiene. **/
+class COptimizeVisitor : public CExpVisitor
+{
+	public:
+		void leave(Exp* e)
+		{
+			for (int i = 0; i < e->getOperandCount(); i++)
+			{
+				Exp*& operand = e->getOperand(i);
+				Exp* opt = operand->optimizeNode();
+				if (opt != NULL)
+				{
+					delete operand;
+					operand = opt;
+				}
+			}
+		}
+};
+
+/** Analiza la pureza de cada nodo; los operadores no acceden a variables. **/
+class CPureVisitor : public CExpVisitor
+{
+	private:
+		CPilaDeSimbolos& stack;
+		set<string>& calls;
+	public:
+		bool pure;
+		CPureVisitor(CPilaDeSimbolos& s, set<string>& c) : stack(s), calls(c), pure(true) {}
+		void leave(Exp* e) { pure = e->isPureNode(stack, calls) && pure; }
+};
+
+/** Evalua la expresion con una pila de valores, como lo haria la JVM. **/
+class CEvalVisitor : public CExpVisitor
+{
+	private:
+		CEvalContext& ctx;
+	public:
+		vector<CValue> values;
+		bool failed;
+		CEvalVisitor(CEvalContext& c) : ctx(c), failed(false) {}
+		bool enter(Exp*) { return !failed; }
+		void leave(Exp* e)
+		{
+			if (failed)
+			{
+				return;
+			}
+			int n = e->getOperandCount();
+			CValue res;
+			if (!e->evalNode(ctx, (n > 0) ? &values[values.size() - n] : NULL, res))
+			{
+				failed = true;
+				return;
+			}
+			values.resize(values.size() - n);
+			values.push_back(res);
+		}
+};
+
+/** Registra las variables y llamadas de la expresion en CLoopInfo. **/
+class CScanLoopVisitor : public CExpVisitor
+{
+	private:
+		CLoopInfo& info;
+	public:
+		CScanLoopVisitor(CLoopInfo& i) : info(i) {}
+		void leave(Exp* e) { e->scanLoopNode(info); }
+};
+
+/** Resuelve las hojas y calcula el tipo de cada nodo. **/
+class CResolveVisitor : public CExpVisitor
+{
+	private:
+		CPilaDeSimbolos& stack;
+		CFunctionTable& functable;
+	public:
+		CResolveVisitor(CPilaDeSimbolos& s, CFunctionTable& f) : stack(s), functable(f) {}
+		void leave(Exp* e)
+		{
+			if (e->getOperandCount() == 0)
+			{
+				e->resolve(stack, functable);
+			}
+			else
+			{
+				e->getType(stack, functable);
+			}
+		}
+};
+
+/** Determina para cada nodo si es invariante en el ciclo: lo es el nodo en si y todos sus operandos. **/
+class CInvariantVisitor : public CExpVisitor
+{
+	private:
+		CLoopInfo& info;
+		CPilaDeSimbolos& stack;
+	public:
+		map<Exp*, bool> invariant;
+		CInvariantVisitor(CLoopInfo& i, CPilaDeSimbolos& s) : info(i), stack(s) {}
+		void leave(Exp* e)
+		{
+			bool inv = e->isInvariantNode(info, stack);
+			for (int i = 0; i < e->getOperandCount(); i++)
+			{
+				inv = inv && invariant[e->getOperand(i)];
+			}
+			invariant[e] = inv;
+		}
+};
+
+/** Determina para cada nodo si su evaluacion puede lanzar una excepcion. **/
+class CThrowVisitor : public CExpVisitor
+{
+	private:
+		CPilaDeSimbolos& stack;
+		CFunctionTable& functable;
+	public:
+		map<Exp*, bool> throws;
+		CThrowVisitor(CPilaDeSimbolos& s, CFunctionTable& f) : stack(s), functable(f) {}
+		void leave(Exp* e)
+		{
+			bool t = e->canThrowNode(stack, functable);
+			for (int i = 0; i < e->getOperandCount(); i++)
+			{
+				t = t || throws[e->getOperand(i)];
+			}
+			throws[e] = t;
+		}
+};
+
+/**
+ * Si la expresion es invariante en el ciclo y se puede evaluar antes de el, se guarda en
+ * una variable temporal que la sustituye. Sino se buscan subexpresiones invariantes.
+ **/
+static void hoistExp(Exp*& root, CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Se calcula de una vez, de las hojas a la raiz, que subexpresiones son invariantes y cuales pueden fallar
+	CInvariantVisitor inv(info, stack);
+	root->walk(inv);
+	CThrowVisitor thr(stack, functable);
+	if (!info.inCondition)
+	{
+		root->walk(thr);
+	}
+
+	//Se recorre desde la raiz, sacando del ciclo las subexpresiones invariantes mas grandes
+	vector<Exp**> pending;
+	pending.push_back(&root);
+	//Partes de una expresion ya informada como no adelantada, para --remarks
+	set<Exp*> reported;
+	while (!pending.empty())
+	{
+		Exp*& e = *pending.back();
+		pending.pop_back();
+
+		//La condicion siempre se evalua: basta que no tenga efectos laterales que puedan adelantarse.
+		//El cuerpo puede no ejecutarse, por lo que la expresion no puede fallar.
+		bool safe = info.inCondition ? !info.condEffects : !thr.throws[e];
+
+		Tipo t;
+		if (safe && inv.invariant[e] && util::ExpType2Tipo(e->getType(stack, functable), t))
+		{
+			//Las constantes y las variables locales no ganan nada, y dentro no hay nada mas que sacar
+			IDNode* var = e->getVar();
+			if (e->isConst() || (var != NULL && stack.GetAsmID(var->toString()) >= 0))
+			{
+				continue;
+			}
+			ostringstream name;
+			name << "__licm" << hoistedTemps++;
+			if (remarks.isEnabled())
+			{
+				remark(RK_PASSED, PASS_LICM, "Hoisted", e->getLine(), remarkText(e) + " is loop invariant: computed once before the loop in " + name.str());
+			}
+			info.hoisted.push_back(new DeclNode(t, new IDNode(name.str()), e));
+			int l = e->getLine();
+			e = new IDNode(name.str());
+			e->setLine(l);
+			continue;
+		}
+		if (!safe && inv.invariant[e] && remarks.isEnabled() && !e->isConst() && e->getVar() == NULL && reported.find(e) == reported.end())
+		{
+			//Invariante, pero no se puede adelantar; se siguen buscando partes que si
+			remark(RK_MISSED, PASS_LICM, "NotHoisted", e->getLine(), remarkText(e) + " is loop invariant but not hoisted: " +
+				(info.inCondition ? "the loop condition has side effects" : "it may fail and the loop body may not run"));
+			reported.insert(e);
+		}
+		if (reported.find(e) != reported.end())
+		{
+			for (int i = 0; i < e->getOperandCount(); i++)
+			{
+				reported.insert(e->getOperand(i));
+			}
+		}
+		//En orden inverso, para recorrer primero el primer operando
+		for (int i = e->getOperandCount() - 1; i >= 0; i--)
+		{
+			pending.push_back(&e->getOperand(i));
+		}
+	}
+}
 
 
 /** Implementacion de la Clase RootNode **/
@@ -57,11 +684,158 @@ void RootNode::prettyPrint(ostream& out, int depth)
 	}
 }
 
+void RootNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++)
+	{
+		(*it)->countNodes(counts);
+	}
+}
+
+/** Valida en paralelo el cuerpo de cada funcion, con su propia copia de las globales. **/
+class CCheckTask : public CParallelTask
+{
+	private:
+		vector<FuncDeclNode*>& funcs;
+		CPilaDeSimbolos& globals;
+		CFunctionTable& functable;
+		pthread_mutex_t mutex;
+	public:
+		vector<string> messages;
+		vector<char> ok;
+
+		CCheckTask(vector<FuncDeclNode*>& f, CPilaDeSimbolos& s, CFunctionTable& ft) : funcs(f), globals(s), functable(ft), messages(f.size()), ok(f.size())
+		{
+			pthread_mutex_init(&mutex, NULL);
+		}
+
+		void run(int i)
+		{
+			ostringstream out;
+			errOut = &out;
+			bool saved = semantics;
+			semantics = true;
+
+			//Las globales que se asignan se marcan en la pila compartida, por eso se copia y combina con el lock
+			CPilaDeSimbolos stack;
+			pthread_mutex_lock(&mutex);
+			stack.CopiarGlobales(globals, funcs[i]->getVisibleGlobals());
+			pthread_mutex_unlock(&mutex);
+
+			CFunctionTable::setVisible(funcs[i]->getVisibleFunctions());
+			funcs[i]->checkBody(stack, functable);
+			CFunctionTable::setVisible(-1);
+
+			pthread_mutex_lock(&mutex);
+			stack.CombinarAsignadas(globals);
+			pthread_mutex_unlock(&mutex);
+
+			messages[i] = out.str();
+			ok[i] = semantics;
+			semantics = saved;
+			errOut = NULL;
+		}
+
+		~CCheckTask()
+		{
+			pthread_mutex_destroy(&mutex);
+		}
+};
+
 void RootNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
+	//Primero, en orden, las globales y las firmas de las funciones
+	vector<FuncDeclNode*> funcs;
+	vector<string> messages;
 	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++)
-	{		
-		(*it)->checkSemantics(stack, functable);
+	{
+		ostringstream out;
+		errOut = &out;
+		FuncDeclNode* func = dynamic_cast<FuncDeclNode*>(*it);
+		if (func != NULL)
+		{
+			func->declare(stack, functable);
+			funcs.push_back(func);
+		}
+		else
+		{
+			(*it)->checkSemantics(stack, functable);
+		}
+		messages.push_back(out.str());
+		errOut = NULL;
+	}
+
+	//Luego los cuerpos de las funciones, en paralelo
+	CCheckTask task(funcs, stack, functable);
+	parallelFor(funcs.size(), task);
+
+	//Los mensajes de cada declaracion se imprimen en el orden del fuente
+	int f = 0;
+	int i = 0;
+	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++, i++)
+	{
+		cout << messages[i];
+		if (dynamic_cast<FuncDeclNode*>(*it) != NULL)
+		{
+			cout << task.messages[f];
+			semantics = task.ok[f] && semantics;
+			f++;
+		}
+	}
+}
+
+void RootNode::analyzePurity()
+{
+	//Analisis de pureza. La pila de simbolos distingue las variables locales de las globales.
+	funcDecls.clear();
+	CPilaDeSimbolos stack;
+	set<string> calls;
+	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++)
+	{
+		FuncDeclNode* func = dynamic_cast<FuncDeclNode*>(*it);
+		if (func != NULL && funcDecls.find(func->getId()) == funcDecls.end())
+		{
+			funcDecls[func->getId()] = func;
+		}
+		(*it)->isPure(stack, calls);
+	}
+
+	//Una funcion es pura si ademas todas las funciones que invoca lo son
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+		{
+			FuncDeclNode* func = it->second;
+			if (!func->isPureFunction())
+			{
+				continue;
+			}
+			for (set<string>::iterator c = func->getCallees().begin(); c != func->getCallees().end(); c++)
+			{
+				if (isPureBuiltin(*c))
+				{
+					continue;
+				}
+				map<string, FuncDeclNode*>::iterator callee = funcDecls.find(*c);
+				if (callee == funcDecls.end() || !callee->second->isPureFunction())
+				{
+					func->setPure(false);
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+void RootNode::memoizeRecursive()
+{
+	for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+	{
+		memoizeFunction(it->second);
 	}
 }
 
@@ -74,14 +848,124 @@ Exp* RootNode::optimize()
 	return NULL;
 }
 
-void RootNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+//Declaraciones que se compilan en paralelo antes de escribirlas, y tamano inicial de sus buffers
+const int compileBatch = 1024;
+const int methodBufferSize = 1 << 12;
+
+/**
+ * Compila en paralelo una tanda de declaraciones, cada una en su propio buffer en memoria.
+ * Los buffers se reusan en las tandas siguientes.
+ **/
+class CCompileTask : public CParallelTask
 {
-	label = 0;
+	private:
+		vector<Node*>& nodes;
+		CFunctionTable& functable;
+	public:
+		//Primera declaracion de la tanda
+		int first;
+		vector<CEmitter*> code;
+
+		CCompileTask(vector<Node*>& n, CFunctionTable& ft, int size) : nodes(n), functable(ft), first(0), code(size)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				code[i] = new CEmitter(methodBufferSize);
+			}
+		}
+
+		~CCompileTask()
+		{
+			for (unsigned int i = 0; i < code.size(); i++)
+			{
+				delete code[i];
+			}
+		}
 
-	//Compilar instrucciones
+		void run(int i)
+		{
+			code[i]->reset();
+			nodes[first + i]->compile(*code[i], functable);
+		}
+};
+
+void RootNode::compile(ostream& out, CFunctionTable& functable)
+{
+	//Compilar instrucciones, cada metodo numera sus etiquetas desde 0 y el resultado
+	//se concatena en el orden del fuente
+	vector<Node*> nodes(children->begin(), children->end());
+	int count = nodes.size();
+	CCompileTask task(nodes, functable, (count < compileBatch) ? count : compileBatch);
+	for (task.first = 0; task.first < count; task.first += compileBatch)
+	{
+		int size = (count - task.first < compileBatch) ? count - task.first : compileBatch;
+		parallelFor(size, task);
+		for (int i = 0; i < size; i++)
+		{
+			out.write(task.code[i]->getData(), task.code[i]->getSize());
+		}
+	}
+
+	compileClassInit(out);
+	compileProfileWriter(out);
+}
+
+void RootNode::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable& functable, ostream& report)
+{
+	//Las variables globales ya estan en la pila luego de checkSemantics
+	hoistedTemps = 0;
 	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++)
-	{		
-		(*it)->compile(out, stack, functable);
+	{
+		if (dynamic_cast<FuncDeclNode*>(*it) != NULL)
+		{
+			(*it)->hoistInvariants(stack, functable, report);
+		}
+	}
+}
+
+/** Resuelve en paralelo los identificadores de cada funcion, con su propia copia de las globales. **/
+class CResolveTask : public CParallelTask
+{
+	private:
+		vector<FuncDeclNode*>& funcs;
+		CPilaDeSimbolos& globals;
+		CFunctionTable& functable;
+	public:
+		CResolveTask(vector<FuncDeclNode*>& f, CPilaDeSimbolos& s, CFunctionTable& ft) : funcs(f), globals(s), functable(ft) {}
+
+		void run(int i)
+		{
+			CPilaDeSimbolos stack;
+			stack.CopiarGlobales(globals, -1);
+			funcs[i]->resolve(stack, functable);
+		}
+};
+
+void RootNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Las globales ya estan en la pila desde checkSemantics, DeclNode solo las asocia
+	vector<FuncDeclNode*> funcs;
+	for (list<Node*>::iterator it = children->begin(); it != children->end(); it++)
+	{
+		FuncDeclNode* func = dynamic_cast<FuncDeclNode*>(*it);
+		if (func != NULL)
+		{
+			funcs.push_back(func);
+		}
+		else
+		{
+			(*it)->resolve(stack, functable);
+		}
+	}
+	CResolveTask task(funcs, stack, functable);
+	parallelFor(funcs.size(), task);
+}
+
+void RootNode::compileFields(ostream& out)
+{
+	for (map<string, FuncDeclNode*>::iterator it = funcDecls.begin(); it != funcDecls.end(); it++)
+	{
+		it->second->compileFields(out);
 	}
 }
 
@@ -90,6 +974,111 @@ void RootNode::append(Node *node)
 	children->push_front(node);
 }
 
+void RootNode::merge(RootNode* other)
+{
+	children->splice(children->end(), *other->children);
+}
+
+Node* RootNode::takeFirst()
+{
+	if (children->empty())
+	{
+		return NULL;
+	}
+	Node* first = children->front();
+	children->pop_front();
+	return first;
+}
+
+/** Implementacion de la Clase CStreamCompiler **/
+CStreamCompiler::CStreamCompiler(CPilaDeSimbolos& s, CFunctionTable& ft, ostream& o, ostream& op, ostream& l, ostream& m) : stack(s), functable(ft), out(o), opt(op), licm(l), methods(m)
+{
+	funcDecls.clear();
+	hoistedTemps = 0;
+}
+
+void CStreamCompiler::add(Node* node)
+{
+	if (compileStats.isEnabled())
+	{
+		node->countNodes(compileStats.getNodes());
+	}
+	if (emitAst)
+	{
+		compileStats.enter(PH_PRETTY_PRINT);
+		node->prettyPrint(out, 0);
+	}
+
+	compileStats.enter(PH_OPTIMIZE);
+
+	//Pureza y memoizacion. Una funcion solo puede invocar funciones declaradas antes que ella
+	//(o a si misma), por lo que ya se sabe si las que invoca son puras.
+	FuncDeclNode* func = dynamic_cast<FuncDeclNode*>(node);
+	set<string> calls;
+	node->isPure(purity, calls);
+	if (func != NULL && funcDecls.find(func->getId()) == funcDecls.end())
+	{
+		funcDecls[func->getId()] = func;
+		for (set<string>::iterator c = func->getCallees().begin(); c != func->getCallees().end(); c++)
+		{
+			if (!isPureCall(*c))
+			{
+				func->setPure(false);
+			}
+		}
+		if (passes.isEnabled(PASS_MEMOIZE))
+		{
+			memoizeFunction(func);
+		}
+	}
+
+	//Las llamadas a funciones ya liberadas no se evaluan en tiempo de compilacion
+	if (passes.isEnabled(PASS_FOLD))
+	{
+		node->optimize();
+	}
+	if (emitOptAst)
+	{
+		compileStats.enter(PH_PRETTY_PRINT);
+		node->prettyPrint(opt, 0);
+	}
+
+	compileStats.enter(PH_SEMANTICS);
+	node->checkSemantics(stack, functable);
+	if (func == NULL)
+	{
+		//Variable global: queda en la pila, el nodo ya no hace falta
+		delete node;
+		compileStats.enter(PH_PARSE);
+		return;
+	}
+
+	//Luego del primer error solo se valida el resto del fuente
+	if (semantics)
+	{
+		if (passes.isEnabled(PASS_LICM))
+		{
+			compileStats.enter(PH_LICM);
+			func->hoistInvariants(stack, functable, licm);
+		}
+		compileStats.enter(PH_RESOLVE);
+		func->resolve(stack, functable);
+		compileStats.enter(PH_CODEGEN);
+		func->compile(methods, functable);
+	}
+	compileStats.enter(PH_TEARDOWN);
+	func->release();
+	signatures.append(func);
+	//Sigue el parser con la proxima declaracion
+	compileStats.enter(PH_PARSE);
+}
+
+void CStreamCompiler::finish()
+{
+	compileClassInit(methods);
+	compileProfileWriter(methods);
+}
+
 /** Implementacion de Clase StmtIf **/
 StmtIf::StmtIf(Exp *e, Statement* trueStmt, Statement* falseStmt)
 {
@@ -124,12 +1113,23 @@ void StmtIf::prettyPrint(ostream& out, int depth)
 	}
 }
 
+void StmtIf::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	exp->countNodes(counts);
+	trueStmt->countNodes(counts);
+	if (falseStmt != NULL)
+	{
+		falseStmt->countNodes(counts);
+	}
+}
+
 void StmtIf::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	//Revisar que la expresion sea booleana
 	if (exp->getType(stack, functable) != ET_BOOL)
 	{
-		cout << "Error: line[" << linenum << "]: Conditional expression is not Boolean" << endl;		
+		errors() << "Error: line[" << linenum << "]: Conditional expression is not Boolean" << endl;		
 		semantics = false;
 	}
 	//Revisar Declaraciones:
@@ -166,17 +1166,47 @@ Exp* StmtIf::optimize()
 	return NULL;
 }
 
-void StmtIf::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+bool StmtIf::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	bool pure = exp->isPure(stack, calls);
+	pure = trueStmt->isPure(stack, calls) && pure;
+	if (falseStmt != NULL)
+	{
+		pure = falseStmt->isPure(stack, calls) && pure;
+	}
+	return pure;
+}
+
+EExecResult StmtIf::exec(CEvalContext& ctx)
+{
+	CValue cond;
+	if (!ctx.step() || !exp->eval(ctx, cond) || cond.tipo != ET_BOOL)
+	{
+		return EX_FAIL;
+	}
+	if (cond.b)
+	{
+		return trueStmt->exec(ctx);
+	}
+	if (falseStmt != NULL)
+	{
+		return falseStmt->exec(ctx);
+	}
+	return EX_NORMAL;
+}
+
+void StmtIf::compile(ostream& out, CFunctionTable& functable)
 {
 	//Compilar expresion
-	exp->compile(out, stack, functable);
+	compileLine(out, exp->getLine());
+	exp->compile(out, functable);
 
 	//Decidir si vamos por if o else
 	int lblCmp = label++; //label de la comparacion
 	out << "\tifeq Label" << lblCmp << "\n"; //ifeq salta si la condicion es falsa
 
 	//Compilar cuerpo true
-	trueStmt->compile(out, stack, functable); 
+	trueStmt->compile(out, functable); 
 
 	//Label para saltar el "else"
 	int lblNoElse = label++;
@@ -188,11 +1218,50 @@ void StmtIf::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& funct
 	//Compilar el cuerpo del else, si no es null
 	if (falseStmt != NULL)
 	{		
-		falseStmt->compile(out, stack, functable); 
+		falseStmt->compile(out, functable); 
 	}
 	out << "Label" << lblNoElse << ":\n";
 }
 
+void StmtIf::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable& functable, ostream& report)
+{
+	trueStmt->hoistInvariants(stack, functable, report);
+	if (falseStmt != NULL)
+	{
+		falseStmt->hoistInvariants(stack, functable, report);
+	}
+}
+
+void StmtIf::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	exp->resolve(stack, functable);
+	trueStmt->resolve(stack, functable);
+	if (falseStmt != NULL)
+	{
+		falseStmt->resolve(stack, functable);
+	}
+}
+
+void StmtIf::scanLoop(CLoopInfo& info)
+{
+	exp->scanLoop(info);
+	trueStmt->scanLoop(info);
+	if (falseStmt != NULL)
+	{
+		falseStmt->scanLoop(info);
+	}
+}
+
+void StmtIf::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	hoistExp(exp, info, stack, functable);
+	trueStmt->hoist(info, stack, functable);
+	if (falseStmt != NULL)
+	{
+		falseStmt->hoist(info, stack, functable);
+	}
+}
+
 StmtIf::~StmtIf()
 {
 	delete exp;
@@ -221,12 +1290,19 @@ void StmtWhile::prettyPrint(ostream& out, int depth)
 	stmt->prettyPrint(out, depth);	
 }
 
+void StmtWhile::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	exp->countNodes(counts);
+	stmt->countNodes(counts);
+}
+
 void StmtWhile::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	//Revisar Expresion Condicional:
 	if (exp->getType(stack, functable) != ET_BOOL)
 	{
-		cout << "Error: Conditional expression in \"while\" construct is not Boolean" << endl;
+		errors() << "Error: Conditional expression in \"while\" construct is not Boolean" << endl;
 		semantics = false;
 	}
 	//Revisar declaraciones:
@@ -240,39 +1316,221 @@ Exp* StmtWhile::optimize()
 	Exp* opt = exp->optimize();
 	if (opt != NULL)
 	{
-		delete exp;
-		exp = opt;
+		delete exp;
+		exp = opt;
+	}
+
+	//Mandar optimizar statements
+	stmt->optimize();
+	return NULL;
+}
+
+bool StmtWhile::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	bool pure = exp->isPure(stack, calls);
+	return stmt->isPure(stack, calls) && pure;
+}
+
+EExecResult StmtWhile::exec(CEvalContext& ctx)
+{
+	while (true)
+	{
+		CValue cond;
+		if (!ctx.step() || !exp->eval(ctx, cond) || cond.tipo != ET_BOOL)
+		{
+			return EX_FAIL;
+		}
+		if (!cond.b)
+		{
+			return EX_NORMAL;
+		}
+		EExecResult res = stmt->exec(ctx);
+		if (res != EX_NORMAL)
+		{
+			return res;
+		}
+	}
+}
+
+void StmtWhile::compile(ostream& out, CFunctionTable& functable)
+{
+	//Las expresiones invariantes y la recarga de las globales son de la linea de la condicion
+	compileLine(out, exp->getLine());
+
+	//Evaluar las expresiones invariantes
+	for (list<DeclNode*>::iterator it = prologue.begin(); it != prologue.end(); it++)
+	{
+		(*it)->compile(out, functable);
 	}
 
-	//Mandar optimizar statements
-	stmt->optimize();
-	return NULL;
-}
+	//Cargar las globales promovidas en variables locales
+	bool outermost = (promotedGlobals == NULL);
+	if (outermost)
+	{
+		promotedGlobals = &promoted;
+		compileReload(out);
+	}
 
-void StmtWhile::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
-{
 	//Etiqueta para la comparacion
 	int lblCmp = label++; //etiqueta para comparar
 	out << "Label" << lblCmp << ":\n";
 
 	//Compilar condicion
-	exp->compile(out, stack, functable);
+	exp->compile(out, functable);
 
 	//Compilar el salto
 	int lblJmp = label++; //etiqueta luego del cuerpo
 	out << "\tifeq Label" << lblJmp << "\n";
 
 	//Compilar el cuerpo
-	stmt->compile(out, stack, functable);
+	stmt->compile(out, functable);
+
+	//Contar la iteracion en el salto hacia atras
+	if (profScope != NULL)
+	{
+		profScope->compileCounter(out, profScope->addLoopCounter(exp->getLine()));
+	}
 	
 	out << "\tgoto Label" << lblCmp << "\n";
 	out << "Label" << lblJmp << ":\n";
+
+	//Al salir del ciclo se guardan las globales modificadas
+	if (outermost)
+	{
+		compileWriteBack(out, exp->getLine());
+		promotedGlobals = NULL;
+	}
+}
+
+void StmtWhile::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable& functable, ostream& report)
+{
+	//Relevar lo que se declara, asigna e invoca en el ciclo
+	CLoopInfo info;
+	info.inCondition = true;
+	exp->scanLoop(info);
+	info.inCondition = false;
+	stmt->scanLoop(info);
+
+	//Sustituir las expresiones invariantes por temporales
+	info.inCondition = true;
+	hoistExp(exp, info, stack, functable);
+	info.inCondition = false;
+	stmt->hoist(info, stack, functable);
+
+	//La condicion termina en la linea del while, el ciclo completo donde termina el cuerpo
+	report << "Function " << stack.getCurrFuncID() << ", while at line " << exp->getLine() << ": ";
+	if (info.hoisted.empty())
+	{
+		report << "nothing hoisted\n";
+	}
+	else
+	{
+		report << info.hoisted.size() << " expression(s) hoisted\n";
+	}
+
+	//Las temporales son variables locales de la funcion, declaradas antes del ciclo
+	for (list<DeclNode*>::iterator it = info.hoisted.begin(); it != info.hoisted.end(); it++)
+	{
+		(*it)->prettyPrint(report, tabSize);
+		(*it)->hoistInvariants(stack, functable, report);
+		functable.incLocals(stack.getCurrFuncID());
+		prologue.push_back(*it);
+	}
+
+	//Ciclos anidados
+	stmt->hoistInvariants(stack, functable, report);
+}
+
+void StmtWhile::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Variables temporales de las expresiones invariantes
+	for (list<DeclNode*>::iterator it = prologue.begin(); it != prologue.end(); it++)
+	{
+		(*it)->resolve(stack, functable);
+	}
+
+	//Los ciclos anidados quedan dentro de la region del ciclo exterior. Sin la pasada
+	//promote la lista queda vacia y las globales se acceden con getstatic y putstatic.
+	bool outermost = (promotedGlobals == NULL);
+	promoted.clear();
+	if (outermost && passes.isEnabled(PASS_PROMOTE))
+	{
+		//Sin las temporales de LICM: se calculan antes del ciclo, y una global que solo se usa
+		//en ellas no se usa en el ciclo
+		CLoopInfo info;
+		exp->scanLoop(info);
+		stmt->scanLoop(info);
+		set<string> names(info.used);
+		names.insert(info.assigned.begin(), info.assigned.end());
+		for (set<string>::iterator it = names.begin(); it != names.end(); it++)
+		{
+			//Solo las globales que no quedan ocultas por una declaracion del ciclo
+			Tipo t;
+			if (info.declared.find(*it) != info.declared.end() || stack.GetAsmID(*it) != -1 || !util::ExpType2Tipo(stack.getTipo(*it), t))
+			{
+				continue;
+			}
+			string local = "__g_" + *it;
+			stack.NuevaDefinicion(t, local);
+			functable.incLocals(stack.getCurrFuncID());
+
+			CPromotedGlobal p;
+			p.id = *it;
+			p.type = util::Tipo2ExpType(t);
+			p.slot = stack.GetAsmID(local);
+			p.written = (info.assigned.find(*it) != info.assigned.end());
+			promoted.push_back(p);
+		}
+		if (!promoted.empty() && remarks.isEnabled())
+		{
+			string names;
+			for (list<CPromotedGlobal>::iterator it = promoted.begin(); it != promoted.end(); it++)
+			{
+				names += (names.empty() ? "" : ", ") + it->id;
+			}
+			remark(RK_PASSED, PASS_PROMOTE, "GlobalsPromoted", linenum, "globals kept in local variables during the loop: " + names);
+		}
+	}
+	if (outermost)
+	{
+		promotedGlobals = &promoted;
+	}
+
+	exp->resolve(stack, functable);
+	stmt->resolve(stack, functable);
+
+	if (outermost)
+	{
+		promotedGlobals = NULL;
+	}
+}
+
+void StmtWhile::scanLoop(CLoopInfo& info)
+{
+	for (list<DeclNode*>::iterator it = prologue.begin(); it != prologue.end(); it++)
+	{
+		(*it)->scanLoop(info);
+	}
+	exp->scanLoop(info);
+	stmt->scanLoop(info);
+}
+
+void StmtWhile::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Un ciclo anidado puede no ejecutarse, se trata como parte del cuerpo
+	hoistExp(exp, info, stack, functable);
+	stmt->hoist(info, stack, functable);
 }
 
 StmtWhile::~StmtWhile()
 {
 	delete exp;
 	delete stmt;
+	while (!prologue.empty())
+	{
+		delete prologue.front();
+		prologue.pop_front();
+	}
 }
 
 /** Implementacion de Clase StmtReturn **/
@@ -281,6 +1539,8 @@ StmtReturn::StmtReturn(Exp* exp)
 	linenum = line;
 	//exp podria llegar a ser NULL en el caso de "devolver void"
 	this->exp = exp;
+	funcType = ET_UNKNOWN;
+	inMain = false;
 }
 
 void StmtReturn::prettyPrint(ostream& out, int depth)
@@ -294,6 +1554,15 @@ void StmtReturn::prettyPrint(ostream& out, int depth)
 	out << ";\n";
 }
 
+void StmtReturn::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	if (exp != NULL)
+	{
+		exp->countNodes(counts);
+	}
+}
+
 void StmtReturn::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	if (exp != NULL)
@@ -309,15 +1578,15 @@ void StmtReturn::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functabl
 			case ET_BOOL: if (expType == ET_BOOL) ok = true; break;
 			case ET_STRING: if (expType == ET_STRING) ok = true; break;
 			case ET_FLOAT: if (expType == ET_INT || expType == ET_FLOAT) ok = true; break;
-			case ET_VOID: cout << "Error: line[" << linenum << "]: The function returns void\n"; semantics = false; break;
+			case ET_VOID: errors() << "Error: line[" << linenum << "]: The function returns void\n"; semantics = false; break;
 			default: ok = false;
 		}
 		if (!ok)
 		{
-			cout << "Error: line[" << linenum << "]: Return expression does not match declared return type: ";
+			errors() << "Error: line[" << linenum << "]: Return expression does not match declared return type: ";
 			semantics = false;
-			this->prettyPrint(cout, 0);
-			cout << endl;
+			this->prettyPrint(errors(), 0);
+			errors() << endl;
 		}
 	}
 }
@@ -336,13 +1605,50 @@ Exp* StmtReturn::optimize()
 	return NULL;
 }
 
-void StmtReturn::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+bool StmtReturn::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	return (exp == NULL || exp->isPure(stack, calls));
+}
+
+EExecResult StmtReturn::exec(CEvalContext& ctx)
+{
+	if (!ctx.step())
+	{
+		return EX_FAIL;
+	}
+	if (exp == NULL)
+	{
+		ctx.retVal = CValue();
+		ctx.retVal.tipo = ET_VOID;
+		return EX_RETURN;
+	}
+	return exp->eval(ctx, ctx.retVal) ? EX_RETURN : EX_FAIL;
+}
+
+void StmtReturn::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	if (exp != NULL)
+	{
+		exp->resolve(stack, functable);
+	}
+	funcType = stack.getCurrFuncType();
+	inMain = (stack.getCurrFuncID() == "main");
+}
+
+void StmtReturn::compile(ostream& out, CFunctionTable& functable)
 {
+	compileLine(out, linenum);
+
 	//Si la expresion no es nula, la compilamos
 	if (exp != NULL)
 	{
-		exp->compile(out, stack, functable);
-		ExpType funcType = stack.getCurrFuncType();
+		exp->compile(out, functable);
+		//Un int devuelto por una funcion float se convierte
+		if (funcType == ET_FLOAT && exp->getType() == ET_INT)
+		{
+			out << "\ti2f\n";
+		}
+		compileWriteBack(out);
 		out << "\t";
 		switch (funcType)
 		{
@@ -356,10 +1662,31 @@ void StmtReturn::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& f
 	}
 	else
 	{
+		compileWriteBack(out);
+		if (inMain)
+		{
+			compileExitHooks(out);
+		}
 		out << "\treturn\n";
 	}
 }
 
+void StmtReturn::scanLoop(CLoopInfo& info)
+{
+	if (exp != NULL)
+	{
+		exp->scanLoop(info);
+	}
+}
+
+void StmtReturn::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	if (exp != NULL)
+	{
+		hoistExp(exp, info, stack, functable);
+	}
+}
+
 StmtReturn::~StmtReturn()
 {
 	if (exp != NULL)
@@ -368,6 +1695,105 @@ StmtReturn::~StmtReturn()
 	}
 }
 
+/** Implementacion de la Clase Exp **/
+Exp*& Exp::getOperand(int)
+{
+	cout << "Fatal: expression has no operands" << endl;
+	abort();
+}
+
+void Exp::walk(CExpVisitor& v)
+{
+	if (!v.enter(this))
+	{
+		return;
+	}
+	//Nodos pendientes, con el indice del proximo operando a recorrer
+	vector< pair<Exp*, int> > pending;
+	pending.push_back(pair<Exp*, int>(this, 0));
+	while (!pending.empty())
+	{
+		Exp* node = pending.back().first;
+		int next = pending.back().second;
+		if (next < node->getOperandCount())
+		{
+			pending.back().second++;
+			if (next > 0)
+			{
+				v.between(node, next);
+			}
+			Exp* operand = node->getOperand(next);
+			if (v.enter(operand))
+			{
+				pending.push_back(pair<Exp*, int>(operand, 0));
+			}
+		}
+		else
+		{
+			pending.pop_back();
+			v.leave(node);
+		}
+	}
+}
+
+void Node::countNodes(CNodeCounts& counts)
+{
+	counts.add(typeid(*this));
+}
+
+/** Cuenta cada nodo de la expresion, sin recursion. **/
+class CCountVisitor : public CExpVisitor
+{
+	private:
+		CNodeCounts& counts;
+	public:
+		CCountVisitor(CNodeCounts& c) : counts(c) {}
+
+		bool enter(Exp* e)
+		{
+			e->countNode(counts);
+			return true;
+		}
+};
+
+void Exp::countNodes(CNodeCounts& counts)
+{
+	CCountVisitor v(counts);
+	walk(v);
+}
+
+void Exp::resolveTypes(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CTypeVisitor v(stack, functable);
+	walk(v);
+}
+
+void Exp::deleteOperands()
+{
+	//Los operandos se desenganchan antes de borrarlos, asi sus destructores no recursan
+	vector<Exp*> pending;
+	for (int i = 0; i < getOperandCount(); i++)
+	{
+		pending.push_back(getOperand(i));
+		getOperand(i) = NULL;
+	}
+	while (!pending.empty())
+	{
+		Exp* e = pending.back();
+		pending.pop_back();
+		if (e == NULL)
+		{
+			continue;
+		}
+		for (int i = 0; i < e->getOperandCount(); i++)
+		{
+			pending.push_back(e->getOperand(i));
+			e->getOperand(i) = NULL;
+		}
+		delete e;
+	}
+}
+
 /** Implementacion de Clase BinExp **/
 BinExp::BinExp(EOperator op, Exp *exp1, Exp *exp2)
 { 
@@ -379,7 +1805,17 @@ BinExp::BinExp(EOperator op, Exp *exp1, Exp *exp2)
 
 void BinExp::prettyPrint(ostream& out, int depth)
 { 
-	exp1->prettyPrint(out, depth);
+	CPrintVisitor v(out, depth);
+	walk(v);
+}
+
+void BinExp::prettyPrintPart(ostream& out, int depth, int part)
+{
+	//El operador va entre ambos operandos
+	if (part != 1)
+	{
+		return;
+	}
 	switch (op)
 	{
 		case OP_PLUS: out << " + "; break;
@@ -396,15 +1832,17 @@ void BinExp::prettyPrint(ostream& out, int depth)
 		case OP_GREATEREQ: out << " >= "; break;
 		default: out << " No deberia estar aqui! ";
 	}
-	exp2->prettyPrint(out, depth);
 }
 
 void BinExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {	
-	//Validacion de variables:
-	exp1->checkSemantics(stack, functable);
-	exp2->checkSemantics(stack, functable);
+	//Validacion de variables y de los operandos, luego el operador
+	CCheckVisitor v(stack, functable);
+	walk(v);
+}
 
+void BinExp::checkNode(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
 	//Obtener tipos de las expresiones:
 	ExpType tipoExp1 = exp1->getType(stack, functable);
 	ExpType tipoExp2 = exp2->getType(stack, functable);
@@ -433,13 +1871,13 @@ void BinExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 	else
 	{
 		ok = false;
-		cout << "Error: line[" << linenum << "]: One of the members in binary expression evaluates to void" << endl;
+		errors() << "Error: line[" << linenum << "]: One of the members in binary expression evaluates to void" << endl;
 		semantics = false;
 	}
 
 	if (!ok)
 	{
-		cout << "Error: line[" << linenum << "]: Invalid type used in: \""; this->prettyPrint(cout, 0); cout << "\""<< endl;
+		errors() << "Error: line[" << linenum << "]: Invalid type used in: \""; this->prettyPrint(errors(), 0); errors() << "\""<< endl;
 		semantics = false;
 	}
 	return;
@@ -448,63 +1886,148 @@ void BinExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 
 Exp* BinExp::optimize()
 {
-	float f1, f2;
-	bool isNumExp1 = exp1->isNum(f1);
-	bool isNumExp2 = exp2->isNum(f2);
+	//Optimizar primero los operandos
+	COptimizeVisitor v;
+	walk(v);
+	return optimizeNode();
+}
 
-	//Si ambas son numeros, sustituimos todo el nodo por una constante
-	if (isNumExp1 && isNumExp2 && this->evalType() == ET_ARIT)
-	{		
-		//Evaluamos el tipo pasando una pila y tabla falsos ya que en este punto 
-		//sabemos que no se precisan para evaluar los tipos, al ser constantes.
-		CPilaDeSimbolos dummyStack;
-		CFunctionTable dummyTable;
-		ExpType exp1Type = exp1->getType(dummyStack, dummyTable);
-		ExpType exp2Type = exp2->getType(dummyStack, dummyTable);
-		
-		//Evaluar el operador
-		float result;
-		switch(op)
+Exp* BinExp::optimizeNode()
+{
+	//Si ambos son constantes, sustituimos todo el nodo por una constante
+	if (exp1->isConst() && exp2->isConst())
+	{
+		CEvalContext ctx(funcDecls);
+		CValue result;
+		if (this->eval(ctx, result))
 		{
-			case OP_PLUS: result = f1 + f2; break;
-			case OP_MINUS: result = f1 - f2; break; 
-			case OP_TIMES: result = f1 * f2; break;
-			case OP_DIVIDEBY: result = f1 / f2; break;
-			default: break; //No deberia entrar aqui
+			Exp* folded = literal(result, linenum);
+			if (remarks.isEnabled() && folded == NULL)
+			{
+				remark(RK_MISSED, PASS_FOLD, "NotRepresentable", linenum, remarkText(this) + " not folded: its value cannot be written exactly as a literal");
+			}
+			else if (remarks.isEnabled())
+			{
+				remark(RK_PASSED, PASS_FOLD, "ConstantFolded", linenum, remarkText(this) + " folded to " + remarkText(folded));
+			}
+			return folded;
 		}
-
-		if (exp1Type == ET_INT && exp2Type == ET_INT)
+		if (remarks.isEnabled())
 		{
-			return new IntConst((int)result);
+			remark(RK_MISSED, PASS_FOLD, "EvaluationFailed", linenum, remarkText(this) + " not folded: it fails at run time (division by zero or invalid operands)");
 		}
-		return new FloatConst(result);
 	}
-	else
+	return NULL;
+}
+
+bool BinExp::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	CPureVisitor v(stack, calls);
+	walk(v);
+	return v.pure;
+}
+
+bool BinExp::eval(CEvalContext& ctx, CValue& res)
+{
+	CEvalVisitor v(ctx);
+	walk(v);
+	if (v.failed)
+	{
+		return false;
+	}
+	res = v.values.back();
+	return true;
+}
+
+bool BinExp::evalNode(CEvalContext& ctx, CValue* operands, CValue& res)
+{
+	CValue v1 = operands[0];
+	CValue v2 = operands[1];
+	if (!ctx.step())
+	{
+		return false;
+	}
+
+	if (evalType() == ET_ARIT)
 	{
-		//Si la constante numerica es la primer expresion, la remplazamos
-		if (isNumExp1)
+		//Concatenacion
+		if (v1.tipo == ET_STRING && v2.tipo == ET_STRING)
 		{
-			Exp* opt = exp1->optimize();
-			if (opt != NULL)
+			if (op != OP_PLUS)
 			{
-				delete exp1;
-				exp1 = opt;
-				return NULL; //El padre no podra optimizar mas
+				return false;
 			}
+			res = CValue::ofString(v1.s + v2.s);
+			return true;
 		}
-		//Si la constante numerica era la segunda expresion, la remplazamos
-		if (isNumExp2)
+
+		//Aritmetica entera de 32 bits, con desborde como en la JVM
+		if (v1.tipo == ET_INT && v2.tipo == ET_INT)
 		{
-			Exp* opt = exp2->optimize();
-			if (opt != NULL)
+			unsigned int a = v1.i;
+			unsigned int b = v2.i;
+			switch (op)
 			{
-				delete exp2;
-				exp2 = opt;
-				return NULL; //idem
+				case OP_PLUS: res = CValue::ofInt((int)(a + b)); break;
+				case OP_MINUS: res = CValue::ofInt((int)(a - b)); break;
+				case OP_TIMES: res = CValue::ofInt((int)(a * b)); break;
+				case OP_DIVIDEBY:
+					//La division entre cero se deja para tiempo de ejecucion
+					if (v2.i == 0)
+					{
+						return false;
+					}
+					res = CValue::ofInt((v1.i == INT_MIN && v2.i == -1) ? INT_MIN : v1.i / v2.i);
+					break;
+				default: return false;
 			}
+			return true;
+		}
+
+		//Aritmetica de punto flotante, el entero se convierte (i2f)
+		if (!v1.coerce(ET_FLOAT) || !v2.coerce(ET_FLOAT))
+		{
+			return false;
+		}
+		switch (op)
+		{
+			case OP_PLUS: res = CValue::ofFloat(v1.f + v2.f); break;
+			case OP_MINUS: res = CValue::ofFloat(v1.f - v2.f); break;
+			case OP_TIMES: res = CValue::ofFloat(v1.f * v2.f); break;
+			case OP_DIVIDEBY: res = CValue::ofFloat(v1.f / v2.f); break;
+			default: return false;
 		}
+		return true;
 	}
-	return NULL;
+
+	//Operacion booleana
+	if (op == OP_AND || op == OP_OR)
+	{
+		if (v1.tipo != ET_BOOL || v2.tipo != ET_BOOL)
+		{
+			return false;
+		}
+		res = CValue::ofBool((op == OP_AND) ? (v1.b && v2.b) : (v1.b || v2.b));
+		return true;
+	}
+
+	//Comparacion: ambos operandos se comparan como float con fcmpl (NaN da -1)
+	if (!v1.coerce(ET_FLOAT) || !v2.coerce(ET_FLOAT))
+	{
+		return false;
+	}
+	int cmp = (v1.f > v2.f) ? 1 : ((v1.f == v2.f) ? 0 : -1);
+	switch (op)
+	{
+		case OP_EQUALS: res = CValue::ofBool(cmp == 0); break;
+		case OP_NOTEQUAL: res = CValue::ofBool(cmp != 0); break;
+		case OP_LESS: res = CValue::ofBool(cmp < 0); break;
+		case OP_LESSEQ: res = CValue::ofBool(cmp <= 0); break;
+		case OP_GREATER: res = CValue::ofBool(cmp > 0); break;
+		case OP_GREATEREQ: res = CValue::ofBool(cmp >= 0); break;
+		default: return false;
+	}
+	return true;
 }
 
 bool BinExp::isNum(float& num)
@@ -525,118 +2048,131 @@ bool BinExp::isNum(float& num)
 	return false;
 }
 
-void BinExp::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void BinExp::compile(ostream& out, CFunctionTable& functable)
 {
-	if (this->evalType() == ET_ARIT)
-	{
-		//Obtiene el tipo de las 2 expresiones
-		ExpType expType1 = exp1->getType(stack, functable);
-		ExpType expType2 = exp2->getType(stack, functable);
-		
+	CCompileVisitor v(out, functable);
+	walk(v);
+}
+
+void BinExp::compilePart(ostream& out, CFunctionTable& functable, int part)
+{
+	//Antes del primer operando no hay nada que compilar
+	if (part == 0)
+	{
+		return;
+	}
+
+	//Obtiene el tipo de las 2 expresiones
+	ExpType expType1 = exp1->getType();
+	ExpType expType2 = exp2->getType();
+
+	if (this->evalType() == ET_ARIT)
+	{
 		//Verificar si es concatenacion
 		if ((op == OP_PLUS) && (expType1 == ET_STRING) && (expType2 == ET_STRING))
 		{
-			exp1->compile(out, stack, functable);
-			exp2->compile(out, stack, functable);
-			out << "\tinvokevirtual java/lang/String/concat(Ljava/lang/String;)Ljava/lang/String;\n";
+			if (part == 2)
+			{
+				out << "\tinvokevirtual java/lang/String/concat(Ljava/lang/String;)Ljava/lang/String;\n";
+			}
+			return;
+		}
+
+		//Luego de la 1er expresion: si es entera y la otra float, castea
+		if (part == 1)
+		{
+			if (expType1 == ET_INT && expType2 == ET_FLOAT)
+			{
+				out << "\ti2f\n";
+			}
 			return;
 		}
+		//Idem para la segunda
+		if (expType1 == ET_FLOAT && expType2 == ET_INT)
+		{
+			out << "\ti2f\n";
+		}
+		//determinar el tipo de las intrucciones
+		const char* sType = "\ti";
+		if (expType1 == ET_FLOAT || expType2 == ET_FLOAT)
+		{
+			sType = "\tf";
+		}
+		
+		switch(op)
+		{
+			case OP_PLUS: out << sType << "add\n"; break;
+			case OP_MINUS: out << sType << "sub\n"; break;
+			case OP_TIMES: out << sType << "mul\n"; break;
+			case OP_DIVIDEBY: out << sType << "div\n"; break;
+			default: cout << "Fatal: invalid arithmetic operator" << endl;
+			abort();
+		}
+		return;
+	}
+
+	//Operacion booleana:
+	if (op == OP_AND || op == OP_OR)
+	{
+		if (part == 2)
+		{
+			if (op == OP_AND)
+			{
+				out << "\tiand\n";
+			}
+			else
+			{
+				out << "\tior\n";
+			}
+		}
+		return;
+	}
+
+	//Operacion de comparacion de operandos, ambos se comparan como float
+	if (part == 1)
+	{
+		if (expType1 == ET_INT)
+		{
+			out << "\ti2f\n";
+		}
+		return;
+	}
+	if (expType2 == ET_INT)
+	{
+		out << "\ti2f\n";
+	}
 
-		//Compila la 1er expresion
-		exp1->compile(out, stack, functable);
-		//Si es entera y la otra float, castea
-		if (expType1 == ET_INT && expType2 == ET_FLOAT)
-		{
-			out << "\ti2f\n";
-		}
-		//Idem para la segunda
-		exp2->compile(out, stack, functable);
-		if (expType1 == ET_FLOAT && expType2 == ET_INT)
-		{
-			out << "\ti2f\n";
-		}
-		//determinar el tipo de las intrucciones
-		string sType("\ti");
-		if (expType1 == ET_FLOAT || expType2 == ET_FLOAT)
-		{
-			sType = "\tf";
-		}
-		
-		switch(op)
-		{
-			case OP_PLUS: out << sType << "add\n"; break;
-			case OP_MINUS: out << sType << "sub\n"; break;
-			case OP_TIMES: out << sType << "mul\n"; break;
-			case OP_DIVIDEBY: out << sType << "div\n"; break;
-			default: cout << "Fatal: invalid arithmetic operator" << endl;
-			abort();
-		}
-		return;
-	}
-
-	//Operacion booleana:
-	if (op == OP_AND || op == OP_OR)
-	{
-
-		exp1->compile(out, stack, functable);
-		exp2->compile(out, stack, functable);
-
-		if (op == OP_AND)
-		{
-			out << "\tiand\n";
-		}
-		else
-		{
-			out << "\tior\n";
-		}
-		return;
-
-	}
-
-	//Operacion de comparacion de operandos
-
-	//Determinar los tipos
-	ExpType expType1 = exp1->getType(stack, functable);
-	ExpType expType2 = exp2->getType(stack, functable);
-
-	//Compilamos primero la segunda expresion, por como funciona fcmpl
-	exp1->compile(out, stack, functable);
-	if (expType1 == ET_INT)
-	{
-		out << "\ti2f\n";
-	}
-
-	exp2->compile(out, stack, functable);
-	if (expType2 == ET_INT)
-	{
-		out << "\ti2f\n";
-	}
-
-	string cmpCond;
-	switch (op)
-	{
-		case OP_EQUALS: cmpCond = "ifeq"; break;
-		case OP_NOTEQUAL: cmpCond = "ifne"; break;
-		case OP_LESS: cmpCond = "iflt"; break;
-		case OP_LESSEQ: cmpCond = "ifle"; break;
-		case OP_GREATER: cmpCond = "ifgt"; break;
+	const char* cmpCond;
+	switch (op)
+	{
+		case OP_EQUALS: cmpCond = "ifeq"; break;
+		case OP_NOTEQUAL: cmpCond = "ifne"; break;
+		case OP_LESS: cmpCond = "iflt"; break;
+		case OP_LESSEQ: cmpCond = "ifle"; break;
+		case OP_GREATER: cmpCond = "ifgt"; break;
 		case OP_GREATEREQ: cmpCond = "ifge"; break;
-		default: cout << "Error: Invalid operator in boolean expression " << endl; abort();
-	}
-
-	//Labels:
-	int lblTrue = label++;
-	int lblEnd = label++;
-
-	out << "\tfcmpl\n"; 
-	out << "\t" << cmpCond << " Label" << lblTrue << "\n";
-	out << "\tldc 0\n"; //la condicion no se cumplio, ponemos false en la pila
-	out << "\tgoto Label" << lblEnd << "\n";
-	out << "Label" << lblTrue << ":\n";
-	out << "\tldc 1\n"; //la condicion se cumplio, ponemos true en la pila
+		default: cout << "Error: Invalid operator in boolean expression " << endl; abort();
+	}
+
+	//Labels:
+	int lblTrue = label++;
+	int lblEnd = label++;
+
+	out << "\tfcmpl\n"; 
+	out << "\t" << cmpCond << " Label" << lblTrue << "\n";
+	out << "\tldc 0\n"; //la condicion no se cumplio, ponemos false en la pila
+	out << "\tgoto Label" << lblEnd << "\n";
+	out << "Label" << lblTrue << ":\n";
+	out << "\tldc 1\n"; //la condicion se cumplio, ponemos true en la pila
 	out << "Label" << lblEnd << ":\n";
 }
 
+void BinExp::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CResolveVisitor v(stack, functable);
+	walk(v);
+}
+
 ExpType BinExp::evalType()
 {
 	switch (op)
@@ -660,12 +2196,13 @@ ExpType BinExp::evalType()
 	return ET_UNKNOWN;
 }
 
-ExpType BinExp::getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
+ExpType BinExp::computeType(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	ExpType exp1Type = exp1->getType(stack, functable);
 	ExpType exp2Type = exp2->getType(stack, functable);
+	ExpType opType = evalType();
 
-	if (evalType() == ET_ARIT)
+	if (opType == ET_ARIT)
 	{
 		//Si ambos tipos son iguales, lo devolvemos
 		if (exp1Type == exp2Type)
@@ -681,7 +2218,7 @@ ExpType BinExp::getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
 	}
 	else
 	{
-		if (evalType() == ET_BOOL)
+		if (opType == ET_BOOL)
 		{
 			return ET_BOOL;
 		}
@@ -691,10 +2228,41 @@ ExpType BinExp::getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
 	return ET_UNKNOWN;
 }
 
+void BinExp::scanLoop(CLoopInfo& info)
+{
+	CScanLoopVisitor v(info);
+	walk(v);
+}
+
+void BinExp::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	hoistExp(exp1, info, stack, functable);
+	hoistExp(exp2, info, stack, functable);
+}
+
+bool BinExp::isInvariant(CLoopInfo& info, CPilaDeSimbolos& stack)
+{
+	CInvariantVisitor v(info, stack);
+	walk(v);
+	return v.invariant[this];
+}
+
+bool BinExp::canThrow(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CThrowVisitor v(stack, functable);
+	walk(v);
+	return v.throws[this];
+}
+
+bool BinExp::canThrowNode(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	ExpType type = getType(stack, functable);
+	return (op == OP_DIVIDEBY && type == ET_INT) || (op == OP_PLUS && type == ET_STRING);
+}
+
 BinExp::~BinExp()
 {
-	delete exp1;
-	delete exp2;
+	deleteOperands();
 }
 
 /** Implementacion de Clase UnExp **/
@@ -706,19 +2274,28 @@ UnExp::UnExp(EOperator op, Exp *exp)
 }
 void UnExp::prettyPrint(ostream& out, int depth) 
 { 
+	CPrintVisitor v(out, depth);
+	walk(v);
+}
+
+void UnExp::prettyPrintPart(ostream& out, int depth, int part)
+{
 	if (op == OP_NOT)
 	{
-		out << "!"; exp->prettyPrint(out, depth);
+		if (part == 0)
+		{
+			out << "!";
+		}
 	}
 	else
 	{
 		if (op == OP_PAR)
 		{
-			out << "( "; exp->prettyPrint(out,depth); out << " )";
+			out << ((part == 0) ? "( " : " )");
 		}
-		else
+		else if (part == 0)
 		{
-			out << " Error: linea[" << linenum << "]: Operador Unario no reconocido en: "; exp->prettyPrint(out, depth);
+			out << " Error: linea[" << linenum << "]: Operador Unario no reconocido en: ";
 			semantics = false;
 		}
 	}
@@ -726,8 +2303,13 @@ void UnExp::prettyPrint(ostream& out, int depth)
 
 void UnExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
-	//Validar Expresion
-	exp->checkSemantics(stack, functable);
+	//Validar Expresion y luego la operacion
+	CCheckVisitor v(stack, functable);
+	walk(v);
+}
+
+void UnExp::checkNode(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
 	//Validar operacion
 	if (op == OP_NOT)
 	{
@@ -737,7 +2319,7 @@ void UnExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 		//Si el operador es NOT, la expresion debe ser booleana
 		if (expType != ET_BOOL)
 		{
-			cout << "Error: line[" << linenum << "]: The given expression is not Boolean: \""; this->prettyPrint(cout, 0); cout << "\"" << endl;
+			errors() << "Error: line[" << linenum << "]: The given expression is not Boolean: \""; this->prettyPrint(errors(), 0); errors() << "\"" << endl;
 			semantics = false;
 		}
 	}
@@ -746,18 +2328,73 @@ void UnExp::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 
 Exp* UnExp::optimize()
 {
-	if (op != OP_NOT)
+	COptimizeVisitor v;
+	walk(v);
+	return optimizeNode();
+}
+
+Exp* UnExp::optimizeNode()
+{
+	//Una constante entre parentesis o negada se sustituye por su valor
+	if (exp->isConst())
 	{
-		Exp* opt = exp->optimize();
-		if (opt != NULL)
+		CEvalContext ctx(funcDecls);
+		CValue result;
+		if (this->eval(ctx, result))
 		{
-			delete exp;
-			exp = opt;
+			Exp* folded = literal(result, linenum);
+			//Los parentesis no son una operacion
+			if (remarks.isEnabled() && op != OP_PAR && folded == NULL)
+			{
+				remark(RK_MISSED, PASS_FOLD, "NotRepresentable", linenum, remarkText(this) + " not folded: its value cannot be written exactly as a literal");
+			}
+			else if (remarks.isEnabled() && op != OP_PAR)
+			{
+				remark(RK_PASSED, PASS_FOLD, "ConstantFolded", linenum, remarkText(this) + " folded to " + remarkText(folded));
+			}
+			return folded;
 		}
 	}
 	return NULL;
 }
 
+bool UnExp::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	CPureVisitor v(stack, calls);
+	walk(v);
+	return v.pure;
+}
+
+bool UnExp::eval(CEvalContext& ctx, CValue& res)
+{
+	CEvalVisitor v(ctx);
+	walk(v);
+	if (v.failed)
+	{
+		return false;
+	}
+	res = v.values.back();
+	return true;
+}
+
+bool UnExp::evalNode(CEvalContext& ctx, CValue* operands, CValue& res)
+{
+	if (!ctx.step())
+	{
+		return false;
+	}
+	res = operands[0];
+	if (op == OP_NOT)
+	{
+		if (res.tipo != ET_BOOL)
+		{
+			return false;
+		}
+		res.b = !res.b;
+	}
+	return true;
+}
+
 bool UnExp::isNum(float& num)
 {
 	if (op != OP_NOT && exp->isNum(num))
@@ -767,30 +2404,88 @@ bool UnExp::isNum(float& num)
 	return false;
 }
 
-void UnExp::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void UnExp::compile(ostream& out, CFunctionTable& functable)
 {
-	exp->compile(out, stack, functable);
-	if (op == OP_NOT)
+	CCompileVisitor v(out, functable);
+	walk(v);
+}
+
+void UnExp::compilePart(ostream& out, CFunctionTable& functable, int part)
+{
+	if (part == 1 && op == OP_NOT)
 	{
 		out << "\ticonst_1\n";
 		out << "\tisub\n";
 	}
 }
 
-ExpType UnExp::getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
+void UnExp::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CResolveVisitor v(stack, functable);
+	walk(v);
+}
+
+ExpType UnExp::computeType(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	return exp->getType(stack, functable);
 }
 
+IDNode* UnExp::getVar()
+{
+	//Se quitan los parentesis sin recursion
+	Exp* e = this;
+	for (UnExp* u = this; u != NULL; u = dynamic_cast<UnExp*>(e))
+	{
+		if (u->op != OP_PAR)
+		{
+			return NULL;
+		}
+		e = u->exp;
+	}
+	return e->getVar();
+}
+
+void UnExp::scanLoop(CLoopInfo& info)
+{
+	CScanLoopVisitor v(info);
+	walk(v);
+}
+
+void UnExp::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	hoistExp(exp, info, stack, functable);
+}
+
+bool UnExp::isInvariant(CLoopInfo& info, CPilaDeSimbolos& stack)
+{
+	CInvariantVisitor v(info, stack);
+	walk(v);
+	return v.invariant[this];
+}
+
+bool UnExp::canThrow(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CThrowVisitor v(stack, functable);
+	walk(v);
+	return v.throws[this];
+}
+
 UnExp::~UnExp()
 {
-	delete exp;
+	deleteOperands();
 }
 
 /** Implementacion de la Clase IDNode **/
 IDNode::IDNode(char *name) : id(name)
 { 
 	linenum = line;
+	slot = -2;
+}
+
+IDNode::IDNode(string name) : id(name)
+{ 
+	linenum = line;
+	slot = -2;
 }
 
 void IDNode::prettyPrint(ostream& out, int depth) 
@@ -802,23 +2497,37 @@ void IDNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	if (!(stack.EstaVarDefinida(id)))
 	{
-		cout << "Error: line[" << linenum << "]: Undefined identifier: " << id << endl;
+		errors() << "Error: line[" << linenum << "]: Undefined identifier: " << id << endl;
 		semantics = false;
 	}
 }
 
-void IDNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void IDNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	slot = stack.GetAsmID(id);
+	if (slot == -1 && promotedGlobals != NULL)
+	{
+		for (list<CPromotedGlobal>::iterator it = promotedGlobals->begin(); it != promotedGlobals->end(); it++)
+		{
+			if (it->id == id)
+			{
+				slot = it->slot;
+			}
+		}
+	}
+	getType(stack, functable);
+}
+
+void IDNode::compile(ostream& out, CFunctionTable& functable)
 {	
-	int asmId = stack.GetAsmID(id);
-	if (asmId >= 0) //la variable es local
+	if (slot >= 0) //la variable es local, o una global promovida a local en un ciclo
 	{
-		ExpType type = stack.getTipo(id);
-		out << "\t" << util::compileInst(type) << "load_" << asmId << "\n";
+		out << "\t" << util::compileLocal(getType(), "load", slot) << "\n";
 		return;
 	}
-	if (asmId == -1) //la variable es global
+	if (slot == -1) //la variable es global
 	{
-		out << "\tgetstatic " << className << "/" << id << " " << util::compile(stack.getTipo(id)) << "\n";
+		out << "\tgetstatic " << className << "/" << id << " " << util::compile(getType()) << "\n";
 		return;
 	}
 
@@ -827,7 +2536,37 @@ void IDNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& funct
 	abort();
 }
 
-ExpType IDNode::getType(CPilaDeSimbolos& stack, CFunctionTable&)
+bool IDNode::isPure(CPilaDeSimbolos& stack, set<string>&)
+{
+	//Las variables globales tienen identificador -1, las no definidas -2
+	return (stack.GetAsmID(id) >= 0);
+}
+
+bool IDNode::eval(CEvalContext& ctx, CValue& res)
+{
+	return ctx.step() && ctx.lookup(id, res);
+}
+
+bool IDNode::isInvariant(CLoopInfo& info, CPilaDeSimbolos& stack)
+{
+	if (info.declared.find(id) != info.declared.end() || info.assigned.find(id) != info.assigned.end())
+	{
+		return false;
+	}
+	int asmId = stack.GetAsmID(id);
+	if (asmId == -1)
+	{
+		return !info.globalWrites;
+	}
+	return (asmId >= 0);
+}
+
+void IDNode::scanLoop(CLoopInfo& info)
+{
+	info.used.insert(id);
+}
+
+ExpType IDNode::computeType(CPilaDeSimbolos& stack, CFunctionTable&)
 {
 	return stack.getTipo(id);
 }
@@ -848,12 +2587,18 @@ void IntConst::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 	return;
 }
 
-void IntConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void IntConst::compile(ostream& out, CFunctionTable& functable)
 {
 	out << "\tldc " << i << "\n";
 }
 
-ExpType IntConst::getType(CPilaDeSimbolos& stack, CFunctionTable&)
+bool IntConst::eval(CEvalContext&, CValue& res)
+{
+	res = CValue::ofInt(i);
+	return true;
+}
+
+ExpType IntConst::computeType(CPilaDeSimbolos& stack, CFunctionTable&)
 {
 	return ET_INT; //Constante Entera.
 }
@@ -874,7 +2619,7 @@ void FloatConst::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functabl
 	return;
 }
 
-void FloatConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void FloatConst::compile(ostream& out, CFunctionTable& functable)
 {
 	//No perdamos los decimales al compilar!
 	if ((f - (int)f) == 0)
@@ -887,7 +2632,13 @@ void FloatConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& f
 	}
 }
 
-ExpType FloatConst::getType(CPilaDeSimbolos& stack, CFunctionTable&)
+bool FloatConst::eval(CEvalContext&, CValue& res)
+{
+	res = CValue::ofFloat(f);
+	return true;
+}
+
+ExpType FloatConst::computeType(CPilaDeSimbolos& stack, CFunctionTable&)
 {
 	return ET_FLOAT; //Constante de punto flotante.
 }
@@ -908,12 +2659,23 @@ void StringConst::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functab
 	return;
 }
 
-void StringConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void StringConst::compile(ostream& out, CFunctionTable& functable)
 {
 	out << "\tldc " << s << "\n";
 }
 
-ExpType StringConst::getType(CPilaDeSimbolos& stack, CFunctionTable&)
+bool StringConst::eval(CEvalContext&, CValue& res)
+{
+	//El literal incluye las comillas; no interpretamos secuencias de escape
+	if (s.size() < 2 || s[0] != '"' || s[s.size() - 1] != '"' || s.find('\\') != string::npos)
+	{
+		return false;
+	}
+	res = CValue::ofString(s.substr(1, s.size() - 2));
+	return true;
+}
+
+ExpType StringConst::computeType(CPilaDeSimbolos& stack, CFunctionTable&)
 {
 	return ET_STRING; //Constante literal.
 }
@@ -942,7 +2704,7 @@ void BoolConst::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable
 	return;
 }
 
-void BoolConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void BoolConst::compile(ostream& out, CFunctionTable& functable)
 {
 	if (b)
 	{
@@ -954,7 +2716,13 @@ void BoolConst::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& fu
 	}
 }
 
-ExpType BoolConst::getType(CPilaDeSimbolos& stack, CFunctionTable&)
+bool BoolConst::eval(CEvalContext&, CValue& res)
+{
+	res = CValue::ofBool(b);
+	return true;
+}
+
+ExpType BoolConst::computeType(CPilaDeSimbolos& stack, CFunctionTable&)
 {
 	return ET_BOOL; //Constante booleana.
 }
@@ -984,6 +2752,15 @@ void ArgsNode::prettyPrint(ostream& out, int depth)
 	}
 }
 
+void ArgsNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	for (list< pair<Tipo, IDNode*> >::iterator it = args->begin(); it != args->end(); it++)
+	{
+		it->second->countNodes(counts);
+	}
+}
+
 void ArgsNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	for (list< pair<Tipo, IDNode*> >::iterator it = args->begin(); it != args->end(); it++)
@@ -994,12 +2771,33 @@ void ArgsNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 	}
 }
 
-void ArgsNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void ArgsNode::compile(ostream& out, CFunctionTable& functable)
+{
+	//Los argumentos se definen en resolve, no generan codigo
+}
+
+bool ArgsNode::isPure(CPilaDeSimbolos& stack, set<string>&)
+{
+	for (list< pair<Tipo, IDNode*> >::iterator it = args->begin(); it != args->end(); it++)
+	{
+		stack.NuevaDefinicion(it->first, (it->second)->toString());
+	}
+	return true;
+}
+
+void ArgsNode::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable&, ostream&)
 {
 	for (list< pair<Tipo, IDNode*> >::iterator it = args->begin(); it != args->end(); it++)
 	{
-		pair<Tipo, IDNode*> p = (*it);
-		stack.NuevaDefinicion(p.first, (p.second)->toString()); //NuevaDefinicion le asigna identificadores en asm		
+		stack.NuevaDefinicion(it->first, (it->second)->toString());
+	}
+}
+
+void ArgsNode::resolve(CPilaDeSimbolos& stack, CFunctionTable&)
+{
+	for (list< pair<Tipo, IDNode*> >::iterator it = args->begin(); it != args->end(); it++)
+	{
+		stack.NuevaDefinicion(it->first, (it->second)->toString()); //NuevaDefinicion le asigna identificadores en asm
 	}
 }
 
@@ -1012,96 +2810,200 @@ list<Tipo> ArgsNode::getTypeList()
 		{
 			ret.push_back((*it).first);
 		}
-	}
-	return ret;
-}
+	}
+	return ret;
+}
+
+ArgsNode::~ArgsNode()
+{
+	//esta lista puede ser nula
+	if (args != NULL)
+	{
+		while (!(args->empty()))
+		{
+			pair<Tipo, IDNode*> p = args->front();
+			delete p.second;
+			args->pop_front();
+		}
+		delete args;
+	}
+}
+
+/** Implementacion de la Clase BodyNode	**/
+BodyNode::BodyNode(list<Statement*>* l) 
+{ 
+	linenum = line;
+	this->stmts = l;
+}
+void BodyNode::prettyPrint(ostream& out, int depth) 
+{ 
+	int localDepth = depth; //(depth - tabSize < 0)? 0 : depth - tabSize;
+	util::indent(out, localDepth);
+	out << "{\n";
+	//Imprimir la lista de Statements si exsite.
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			(*it)->prettyPrint(out, depth+tabSize);
+		}
+	}
+	out << "\n";
+	util::indent(out, localDepth);
+	out << "}\n";
+}
+
+void BodyNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			(*it)->countNodes(counts);
+		}
+	}
+}
+
+void BodyNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Crear nuevo Alcance
+	stack.NuevoAlcance();
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			(*it)->checkSemantics(stack, functable);
+		}
+	}
+	//Fin de Alcance
+	stack.FinAlcance();
+}
+
+Exp* BodyNode::optimize()
+{
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			(*it)->optimize();
+		}
+	}
+	return NULL;
+}
+
+bool BodyNode::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	bool pure = true;
+	stack.NuevoAlcance();
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			pure = (*it)->isPure(stack, calls) && pure;
+		}
+	}
+	stack.FinAlcance();
+	return pure;
+}
+
+EExecResult BodyNode::exec(CEvalContext& ctx)
+{
+	EExecResult res = EX_NORMAL;
+	ctx.NuevoAlcance();
+	if (stmts != NULL)
+	{
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end() && res == EX_NORMAL; it++)
+		{
+			res = (*it)->exec(ctx);
+		}
+	}
+	ctx.FinAlcance();
+	return res;
+}
+
+void BodyNode::compile(ostream& out, CFunctionTable& functable)
+{
+	if (stmts != NULL)
+	{
+		//Variables locales del bloque, visibles desde que se inicializan hasta el final del bloque
+		list< pair<DeclNode*, int> > scopes;
+
+		//cout << "-------------ini body--------\n";
+		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
+		{
+			(*it)->compile(out, functable);
+			//debug
+			
+		//	(*it)->prettyPrint(cout, 0);
+			DeclNode* decl = dynamic_cast<DeclNode*>(*it);
+			if (debugInfo && decl != NULL && decl->isLocalVar())
+			{
+				int lblFrom = label++;
+				out << "Scope" << lblFrom << ":\n";
+				scopes.push_back(pair<DeclNode*, int>(decl, lblFrom));
+			}
+		}
+		//cout << "---------------fin body---------\n";
 
-ArgsNode::~ArgsNode()
-{
-	//esta lista puede ser nula
-	if (args != NULL)
-	{
-		while (!(args->empty()))
+		if (!scopes.empty())
 		{
-			pair<Tipo, IDNode*> p = args->front();
-			delete p.second;
-			args->pop_front();
+			int lblTo = label++;
+			out << "Scope" << lblTo << ":\n";
+			for (list< pair<DeclNode*, int> >::iterator it = scopes.begin(); it != scopes.end(); it++)
+			{
+				it->first->compileVar(out, it->second, lblTo);
+			}
 		}
-		delete args;
 	}
 }
 
-/** Implementacion de la Clase BodyNode	**/
-BodyNode::BodyNode(list<Statement*>* l) 
-{ 
-	linenum = line;
-	this->stmts = l;
-}
-void BodyNode::prettyPrint(ostream& out, int depth) 
-{ 
-	int localDepth = depth; //(depth - tabSize < 0)? 0 : depth - tabSize;
-	util::indent(out, localDepth);
-	out << "{\n";
-	//Imprimir la lista de Statements si exsite.
+void BodyNode::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable& functable, ostream& report)
+{
+	stack.NuevoAlcance();
 	if (stmts != NULL)
 	{
 		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
 		{
-			(*it)->prettyPrint(out, depth+tabSize);
+			(*it)->hoistInvariants(stack, functable, report);
 		}
 	}
-	out << "\n";
-	util::indent(out, localDepth);
-	out << "}\n";
+	stack.FinAlcance();
 }
 
-void BodyNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
+void BodyNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
-	//Crear nuevo Alcance
 	stack.NuevoAlcance();
 	if (stmts != NULL)
 	{
 		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
 		{
-			(*it)->checkSemantics(stack, functable);
+			(*it)->resolve(stack, functable);
 		}
 	}
-	//Fin de Alcance
 	stack.FinAlcance();
 }
 
-Exp* BodyNode::optimize()
+void BodyNode::scanLoop(CLoopInfo& info)
 {
 	if (stmts != NULL)
 	{
 		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
 		{
-			(*it)->optimize();
+			(*it)->scanLoop(info);
 		}
 	}
-	return NULL;
 }
 
-void BodyNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+void BodyNode::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
-	//Crear alcance
-	stack.NuevoAlcance();
-
 	if (stmts != NULL)
 	{
-		//cout << "-------------ini body--------\n";
 		for (list<Statement*>::iterator it = stmts->begin(); it != stmts->end(); it++)
 		{
-			(*it)->compile(out, stack, functable);
-			//debug
-			
-		//	(*it)->prettyPrint(cout, 0);
+			(*it)->hoist(info, stack, functable);
 		}
-		//cout << "---------------fin body---------\n";
 	}
-
-	//Cerrar alcance
-	stack.FinAlcance();
 }
 
 BodyNode::~BodyNode()
@@ -1126,6 +3028,11 @@ FuncDeclNode::FuncDeclNode(Tipo t, IDNode *id, ArgsNode* args, BodyNode* body)
 	this->id = id;
 	this->args = args;
 	this->body = body;
+	this->pure = false;
+	this->memoize = false;
+	this->visibleGlobals = -1;
+	this->visibleFunctions = -1;
+	this->declLine = line;
 }
 void FuncDeclNode::prettyPrint(ostream& out, int depth) 
 { 
@@ -1142,11 +3049,29 @@ void FuncDeclNode::prettyPrint(ostream& out, int depth)
 	out << "\n";
 }
 
+void FuncDeclNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	id->countNodes(counts);
+	if (args != NULL)
+	{
+		args->countNodes(counts);
+	}
+	//Con --stream el cuerpo ya se libero luego de compilar
+	if (body != NULL)
+	{
+		body->countNodes(counts);
+	}
+}
+
 void FuncDeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
-	//Recordar declaracion de funcion
-	stack.NuevaFuncion(retType, id->toString());
-	
+	declare(stack, functable);
+	checkBody(stack, functable);
+}
+
+void FuncDeclNode::declare(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
 	//Obtener lista de tipos
 	list<Tipo> tmp;
 	if (args != NULL)
@@ -1157,25 +3082,41 @@ void FuncDeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functa
 	//Agregar nueva funcion
 	if (!(functable.addFunction(retType, id->toString(), tmp)))
 	{
-		cout << "Error: line[" << linenum << "]: Function redefinition: " << id->toString() << " in: ";
+		errors() << "Error: line[" << linenum << "]: Function redefinition: " << id->toString() << " in: ";
 		semantics = false;
-		this->prettyPrint(cout,0);
-		cout << endl;
+		this->prettyPrint(errors(),0);
+		errors() << endl;
 	}
 
 	//Chequear firma de main
 	if (id->toString() == "main" && args != NULL)
 	{
-		cout << "Error: line[" << linenum << "]: Invalid signature for function \"main\": ";	
+		errors() << "Error: line[" << linenum << "]: Invalid signature for function \"main\": ";	
 		//Imprimir firma
-		util::prettyPrint(cout, retType, 0);
-		cout << "main (";
-		args->prettyPrint(cout, 0);
-		cout << ")\nAvailable candidates are: void main()" << endl;
+		util::prettyPrint(errors(), retType, 0);
+		errors() << "main (";
+		args->prettyPrint(errors(), 0);
+		errors() << ")\nAvailable candidates are: void main()" << endl;
 		//Semantica invalida
 		semantics = false;		
 	}
-	
+
+	//En la pila solo hay globales; la funcion se ve a si misma para las llamadas recursivas
+	visibleGlobals = stack.getLista().size();
+	visibleFunctions = functable.size();
+}
+
+void FuncDeclNode::checkBody(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	CTraceSpan span("checkSemantics", id->toString());
+	if (span.isActive())
+	{
+		span.arg("nodes", countAll());
+	}
+
+	//Recordar declaracion de funcion
+	stack.NuevaFuncion(retType, id->toString());
+
 	//Chequear argumentos
 	if (args != NULL)
 	{
@@ -1193,19 +3134,134 @@ void FuncDeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functa
 
 Exp* FuncDeclNode::optimize()
 {
+	CTraceSpan span("optimize", id->toString());
+	if (span.isActive())
+	{
+		span.arg("nodes", countAll());
+	}
+	remarkScope = this;
 	body->optimize();
+	remarkScope = NULL;
+	if (span.isActive())
+	{
+		span.arg("nodes_after", countAll());
+	}
 	return NULL;
 }
 
-void FuncDeclNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+long FuncDeclNode::countAll()
+{
+	CNodeCounts counts;
+	countNodes(counts);
+	return counts.total;
+}
+
+bool FuncDeclNode::isPure(CPilaDeSimbolos& stack, set<string>&)
 {
 	stack.NuevaFuncion(retType, id->toString());
+	if (args != NULL)
+	{
+		args->isPure(stack, callees);
+	}
+	callees.clear();
+	pure = body->isPure(stack, callees);
+	stack.FinFuncion();
+	return pure;
+}
+
+bool FuncDeclNode::call(CEvalContext& ctx, list<CValue>& values, CValue& res)
+{
+	int argCount = (args != NULL) ? args->getList()->size() : 0;
+	if (body == NULL || argCount != values.size() || !ctx.enterCall())
+	{
+		return false;
+	}
+
+	//Pasaje de parametros
+	if (args != NULL)
+	{
+		list<CValue>::iterator v = values.begin();
+		for (list< pair<Tipo, IDNode*> >::iterator it = args->getList()->begin(); it != args->getList()->end(); it++, v++)
+		{
+			if (!v->coerce(util::Tipo2ExpType(it->first)))
+			{
+				ctx.leaveCall();
+				return false;
+			}
+			ctx.define(it->second->toString(), *v);
+		}
+	}
+
+	EExecResult result = body->exec(ctx);
+	ctx.leaveCall();
+
+	ExpType funcType = util::Tipo2ExpType(retType);
+	if (result == EX_NORMAL)
+	{
+		//Solo una funcion void puede terminar sin return
+		res = CValue();
+		res.tipo = ET_VOID;
+		return (funcType == ET_VOID);
+	}
+	if (result == EX_RETURN)
+	{
+		res = ctx.retVal;
+		if (funcType == ET_VOID)
+		{
+			return (res.tipo == ET_VOID);
+		}
+		return res.coerce(funcType);
+	}
+	return false;
+}
+
+/** Cantidad de instrucciones del codigo jasmin: las lineas indentadas que no son directivas ni comentarios. **/
+static long countInstructions(const string& code)
+{
+	long count = 0;
+	for (size_t i = code.find("\n\t"); i != string::npos; i = code.find("\n\t", i + 1))
+	{
+		if (i + 2 < code.size() && code[i + 2] != '.' && code[i + 2] != ';')
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+void FuncDeclNode::compile(ostream& out, CFunctionTable& functable)
+{
+	CTraceSpan span("compile", id->toString());
+	if (!span.isActive())
+	{
+		compileMethods(out, functable);
+		return;
+	}
+
+	//Con --trace el codigo pasa por un buffer para contar las instrucciones
+	span.arg("nodes", countAll());
+	ostringstream code;
+	compileMethods(code, functable);
+	span.arg("instructions", countInstructions(code.str()));
+	out << code.str();
+}
+
+void FuncDeclNode::compileMethods(ostream& out, CFunctionTable& functable)
+{
+	//Si la funcion esta memoizada, el cuerpo se compila aparte y F pasa a consultar la cache
+	string name = id->toString();
+	if (memoize)
+	{
+		compileMemoWrapper(out, functable);
+		name = name + "__impl";
+	}
+	label = 0;
+	lastLine = 0;
 
 	//Imprimir: .method public static F ( ARGS )TIPO
-	out << "\n.method public static " << id->toString() << "(";
+	out << "\n.method public static " << name << "(";
 	if ((args != NULL) && (id->toString() != "main"))
 	{
-		args->compile(out, stack, functable);
 		//Imprimir los tipos para la llamada
 		for (list< pair<Tipo, IDNode*> >::iterator it = args->getList()->begin(); it != args->getList()->end(); it++)
 		{
@@ -1217,7 +3273,6 @@ void FuncDeclNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable&
 		if (id->toString() == "main")
 		{
 			out << "[Ljava/lang/String;";
-			functable.incLocals(id->toString());
 		}
 	}
 	out << ")" << util::compile(util::Tipo2ExpType(retType)) << "\n";
@@ -1225,13 +3280,53 @@ void FuncDeclNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable&
 	//Imprimir limite de stack y variables
 	out << "\t.limit stack " << maxStack << "\n";
 	out << "\t.limit locals " << functable.getLocals(id->toString()) << "\n"; 
+	if (remarks.isEnabled())
+	{
+		ostringstream limits;
+		limits << name << " uses " << functable.getLocals(id->toString()) << " local variable slots; the operand stack limit is fixed at " << maxStack;
+		remarks.add(RK_ANALYSIS, "codegen", "StackLimits", id->toString(), declLine, limits.str());
+	}
+
+	//Los argumentos son visibles en todo el metodo
+	bool argScope = (debugInfo && args != NULL && !args->getList()->empty() && id->toString() != "main");
+	int lblArgs = 0;
+	if (argScope)
+	{
+		lblArgs = label++;
+		out << "Scope" << lblArgs << ":\n";
+	}
+
+	//main vacia el buffer de print y escribe el perfil tambien si termina con una excepcion
+	bool flushOnThrow = (id->toString() == "main" && (!unbufferedOutput || instrument));
+	int lblBegin = 0;
+	if (flushOnThrow)
+	{
+		lblBegin = label++;
+		out << "Label" << lblBegin << ":\n";
+	}
+
+	//Contar cada ejecucion del cuerpo (en una funcion memoizada, las que no resuelve la cache)
+	if (instrument)
+	{
+		loopLines.clear();
+		profScope = this;
+		compileCounter(out, 0);
+	}
 
 	//Compilar el cuerpo de la funcion
-	body->compile(out, stack, functable);
+	body->compile(out, functable);
+	profScope = NULL;
+
+	//El return final es de la linea que cierra la funcion
+	compileLine(out, linenum);
 
 	//Si el tipo es void, agregamos un return
 	if (retType == TVOID)
 	{	
+		if (id->toString() == "main")
+		{
+			compileExitHooks(out);
+		}
 		out << "\treturn\n";
 	}
 	else
@@ -1242,12 +3337,282 @@ void FuncDeclNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable&
 		out << "return\n";
 	}
 
+	//Manejador: vaciar el buffer y volver a lanzar la excepcion
+	if (flushOnThrow)
+	{
+		int lblHandler = label++;
+		out << ".catch java/lang/Throwable from Label" << lblBegin << " to Label" << lblHandler << " using Label" << lblHandler << "\n";
+		out << "Label" << lblHandler << ":\n";
+		compileProfileDump(out);
+		compileFlushOutput(out);
+		out << "\tathrow\n";
+	}
+
+	//Los argumentos ocupan las primeras variables, en orden
+	if (argScope)
+	{
+		int lblEnd = label++;
+		out << "Scope" << lblEnd << ":\n";
+		int slot = 0;
+		for (list< pair<Tipo, IDNode*> >::iterator it = args->getList()->begin(); it != args->getList()->end(); it++, slot++)
+		{
+			out << ".var " << slot << " is " << it->second->toString() << " " << util::compile(util::Tipo2ExpType(it->first)) << " from Scope" << lblArgs << " to Scope" << lblEnd << "\n";
+		}
+	}
+
 	//Fin metodo
 	out << ".end method\n";
+}
+
+void FuncDeclNode::compileMemoWrapper(ostream& out, CFunctionTable& functable)
+{
+	string name = id->toString();
+	string cache = className + "/" + name + "__memo Ljava/util/HashMap;";
+	ExpType ret = util::Tipo2ExpType(retType);
+
+	//Firma de la funcion
+	string desc("(");
+	list<Tipo> types;
+	if (args != NULL)
+	{
+		types = args->getTypeList();
+	}
+	for (list<Tipo>::iterator it = types.begin(); it != types.end(); it++)
+	{
+		desc += util::compile(util::Tipo2ExpType(*it));
+	}
+	desc += ")";
+	desc += util::compile(ret);
+
+	//Slots de la clave y del resultado, luego de los argumentos
+	int key = types.size();
+	int result = key + 1;
+
+	out << "\n.method public static " << name << desc << "\n";
+	out << "\t.limit stack " << maxStack << "\n";
+	out << "\t.limit locals " << result + 1 << "\n";
+	label = 0;
+
+	//Clave: el argumento, o una lista con todos los argumentos
+	if (types.size() == 0)
+	{
+		out << "\tldc \"\"\n";
+	}
+	else if (types.size() == 1)
+	{
+		ExpType t = util::Tipo2ExpType(types.front());
+		out << "\t" << util::compileLocal(t, "load", 0) << "\n";
+		if (t != ET_STRING)
+		{
+			out << "\t" << util::compileBox(t) << "\n";
+		}
+	}
+	else
+	{
+		out << "\tldc " << types.size() << "\n";
+		out << "\tanewarray java/lang/Object\n";
+		int i = 0;
+		for (list<Tipo>::iterator it = types.begin(); it != types.end(); it++, i++)
+		{
+			ExpType t = util::Tipo2ExpType(*it);
+			out << "\tdup\n";
+			out << "\tldc " << i << "\n";
+			out << "\t" << util::compileLocal(t, "load", i) << "\n";
+			if (t != ET_STRING)
+			{
+				out << "\t" << util::compileBox(t) << "\n";
+			}
+			out << "\taastore\n";
+		}
+		out << "\tinvokestatic java/util/Arrays/asList([Ljava/lang/Object;)Ljava/util/List;\n";
+	}
+	out << "\tastore " << key << "\n";
+
+	//Consultar la cache
+	int lblMiss = label++;
+	out << "\tgetstatic " << cache << "\n";
+	out << "\taload " << key << "\n";
+	out << "\tinvokevirtual java/util/HashMap/get(Ljava/lang/Object;)Ljava/lang/Object;\n";
+	out << "\tdup\n";
+	out << "\tifnull Label" << lblMiss << "\n";
+	out << "\tgetstatic " << className << "/" << name << "__hits I\n";
+	out << "\ticonst_1\n";
+	out << "\tiadd\n";
+	out << "\tputstatic " << className << "/" << name << "__hits I\n";
+	out << "\t" << util::compileUnbox(ret) << "\n";
+	out << "\t" << util::compileInst(ret) << "return\n";
+
+	//Fallo: invocar al cuerpo y guardar el resultado
+	out << "Label" << lblMiss << ":\n";
+	out << "\tpop\n";
+	out << "\tgetstatic " << className << "/" << name << "__misses I\n";
+	out << "\ticonst_1\n";
+	out << "\tiadd\n";
+	out << "\tputstatic " << className << "/" << name << "__misses I\n";
+	int i = 0;
+	for (list<Tipo>::iterator it = types.begin(); it != types.end(); it++, i++)
+	{
+		out << "\t" << util::compileLocal(util::Tipo2ExpType(*it), "load", i) << "\n";
+	}
+	out << "\tinvokestatic " << className << "/" << name << "__impl" << desc << "\n";
+	out << "\t" << util::compileLocal(ret, "store", result) << "\n";
+
+	//Si la cache esta llena se vacia
+	int lblPut = label++;
+	out << "\tgetstatic " << cache << "\n";
+	out << "\tinvokevirtual java/util/HashMap/size()I\n";
+	out << "\tldc " << maxMemoEntries << "\n";
+	out << "\tif_icmplt Label" << lblPut << "\n";
+	out << "\tgetstatic " << cache << "\n";
+	out << "\tinvokevirtual java/util/HashMap/clear()V\n";
+	out << "Label" << lblPut << ":\n";
+	out << "\tgetstatic " << cache << "\n";
+	out << "\taload " << key << "\n";
+	out << "\t" << util::compileLocal(ret, "load", result) << "\n";
+	if (ret != ET_STRING)
+	{
+		out << "\t" << util::compileBox(ret) << "\n";
+	}
+	out << "\tinvokevirtual java/util/HashMap/put(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;\n";
+	out << "\tpop\n";
+	out << "\t" << util::compileLocal(ret, "load", result) << "\n";
+	out << "\t" << util::compileInst(ret) << "return\n";
+	out << ".end method\n";
+}
+
+void FuncDeclNode::compileFields(ostream& out)
+{
+	if (memoize)
+	{
+		out << ".field public static " << id->toString() << "__memo Ljava/util/HashMap;\n";
+		out << ".field public static " << id->toString() << "__hits I\n";
+		out << ".field public static " << id->toString() << "__misses I\n";
+	}
+	//Contadores de --instrument. Final, para que el JIT trate al arreglo como constante.
+	if (instrument)
+	{
+		out << ".field public static final " << id->toString() << "__prof [J\n";
+	}
+}
+
+void FuncDeclNode::compileStaticInit(ostream& out)
+{
+	if (memoize)
+	{
+		out << "\tnew java/util/HashMap\n";
+		out << "\tdup\n";
+		out << "\tinvokespecial java/util/HashMap/<init>()V\n";
+		out << "\tputstatic " << className << "/" << id->toString() << "__memo Ljava/util/HashMap;\n";
+	}
+	if (instrument)
+	{
+		out << "\tldc " << loopLines.size() + 1 << "\n";
+		out << "\tnewarray long\n";
+		out << "\tputstatic " << className << "/" << id->toString() << "__prof [J\n";
+	}
+}
+
+int FuncDeclNode::addLoopCounter(int l)
+{
+	loopLines.push_back(l);
+	return loopLines.size();
+}
+
+void FuncDeclNode::compileCounter(ostream& out, int counter)
+{
+	//F__prof[counter]++, sin variables locales
+	out << "\tgetstatic " << className << "/" << id->toString() << "__prof [J\n";
+	out << "\tldc " << counter << "\n";
+	out << "\tdup2\n";
+	out << "\tlaload\n";
+	out << "\tlconst_1\n";
+	out << "\tladd\n";
+	out << "\tlastore\n";
+}
+
+void FuncDeclNode::compileProfile(ostream& out)
+{
+	for (unsigned int i = 0; i <= loopLines.size(); i++)
+	{
+		out << "\taload_0\n";
+		if (i == 0)
+		{
+			out << "\tldc \"call\\t" << id->toString() << "\\t" << declLine << "\\t\"\n";
+		}
+		else
+		{
+			out << "\tldc \"loop\\t" << id->toString() << "\\t" << loopLines[i - 1] << "\\t\"\n";
+		}
+		out << "\tinvokevirtual java/io/PrintStream/print(Ljava/lang/String;)V\n";
+		out << "\taload_0\n";
+		out << "\tgetstatic " << className << "/" << id->toString() << "__prof [J\n";
+		out << "\tldc " << i << "\n";
+		out << "\tlaload\n";
+		out << "\tinvokevirtual java/io/PrintStream/println(J)V\n";
+	}
+}
+
+void FuncDeclNode::compileMemoStats(ostream& out)
+{
+	if (memoize)
+	{
+		//memo F: hits=N misses=M, por stderr para no mezclarse con la salida del programa
+		out << "\tgetstatic java/lang/System/err Ljava/io/PrintStream;\n";
+		out << "\tldc \"memo " << id->toString() << ": hits=\"\n";
+		out << "\tinvokevirtual java/io/PrintStream/print(Ljava/lang/String;)V\n";
+		out << "\tgetstatic java/lang/System/err Ljava/io/PrintStream;\n";
+		out << "\tgetstatic " << className << "/" << id->toString() << "__hits I\n";
+		out << "\tinvokevirtual java/io/PrintStream/print(I)V\n";
+		out << "\tgetstatic java/lang/System/err Ljava/io/PrintStream;\n";
+		out << "\tldc \" misses=\"\n";
+		out << "\tinvokevirtual java/io/PrintStream/print(Ljava/lang/String;)V\n";
+		out << "\tgetstatic java/lang/System/err Ljava/io/PrintStream;\n";
+		out << "\tgetstatic " << className << "/" << id->toString() << "__misses I\n";
+		out << "\tinvokevirtual java/io/PrintStream/println(I)V\n";
+	}
+}
+
+void FuncDeclNode::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable& functable, ostream& report)
+{
+	stack.NuevaFuncion(retType, id->toString());
+	remarkScope = this;
+	if (args != NULL)
+	{
+		args->hoistInvariants(stack, functable, report);
+	}
+	body->hoistInvariants(stack, functable, report);
+	remarkScope = NULL;
+	stack.FinFuncion();
+}
 
+void FuncDeclNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	stack.NuevaFuncion(retType, id->toString());
+	if ((args != NULL) && (id->toString() != "main"))
+	{
+		args->resolve(stack, functable);
+	}
+	else if (id->toString() == "main")
+	{
+		//main recibe el arreglo de argumentos de java
+		functable.incLocals(id->toString());
+	}
+	remarkScope = this;
+	body->resolve(stack, functable);
+	remarkScope = NULL;
 	stack.FinFuncion();
 }
 
+void FuncDeclNode::release()
+{
+	delete body;
+	body = NULL;
+	delete args;
+	args = NULL;
+	//Las funciones que se declaren luego no pueden ser invocadas desde esta
+	callees.clear();
+}
+
 FuncDeclNode::~FuncDeclNode()
 {
 	delete id;
@@ -1264,89 +3629,130 @@ FuncDeclNode::~FuncDeclNode()
 }
 
 /** Implementacion de la Clase FCallNode **/
-FCallNode::FCallNode(IDNode* id, list<Exp*>* params, bool isStmt) 
-{ 
+FCallNode::FCallNode(IDNode* id, list<Exp*>* params, bool isStmt)
+{
 	Exp::linenum = line;
 	this->id = id;
 	this->isStmt = isStmt;
-	this->args = params;
+	//los parametros pueden ser null
+	if (params != NULL)
+	{
+		args.assign(params->begin(), params->end());
+		delete params;
+	}
+	this->signature = NULL;
 }
 
-void FCallNode::prettyPrint(ostream& out, int depth) 
-{ 
-	util::indent(out, depth);
-	id->prettyPrint(out, depth);
-	//Imprimir los parametros, si existen
-	out << "( ";
-	if (args != NULL)
+void FCallNode::prettyPrint(ostream& out, int depth)
+{
+	CPrintVisitor v(out, depth);
+	walk(v);
+}
+
+void FCallNode::prettyPrintPart(ostream& out, int depth, int part)
+{
+	if (part == 0)
 	{
-		int i = 0;
-		for (list<Exp*>::iterator it = args->begin(); it != args->end(); it++)
+		util::indent(out, depth);
+		id->prettyPrint(out, depth);
+		out << "( ";
+	}
+	else
+	{
+		//Los parametros se separan con comas
+		if (part < args.size())
 		{
-			(*it)->prettyPrint(out, 0);
-			if (i < args->size() -1)
-				out << ", ";
-			++i;
+			out << ", ";
 		}
 	}
-	out << " )";
-	if (isStmt)
+	if (part == args.size())
 	{
-		out << ";\n";
+		out << " )";
+		if (isStmt)
+		{
+			out << ";\n";
+		}
 	}
 }
 
+void FCallNode::countNode(CNodeCounts& counts)
+{
+	Exp::countNode(counts);
+	id->countNodes(counts);
+}
+
 void FCallNode::setStmt(bool b)
 {
 	isStmt = b;
 }
 
+CFuncArgsType* FCallNode::getSignature(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	if (signature == NULL)
+	{
+		vector<ExpType> types;
+		for (int i = 0; i < args.size(); i++)
+		{
+			types.push_back(args[i]->getType(stack, functable));
+		}
+		signature = functable.resolve(id->toString(), types);
+	}
+	return signature;
+}
+
 void FCallNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
-	//Chequear que la funcion este definida	
-	if ( !(functable.isDeclared(id->toString())) )
+	//Validacion de los argumentos (un id debe estar definido, una expresion bien formada, etc), luego la llamada
+	CCheckVisitor v(stack, functable);
+	walk(v);
+}
+
+void FCallNode::checkNode(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Firma que corresponde a los tipos de los argumentos (print tiene una por tipo)
+	CFuncArgsType* func = getSignature(stack, functable);
+	int argCount = (func != NULL) ? func->getArgCount() : -1;
+
+	//Chequear que la funcion este definida
+	if (func == NULL)
 	{
-		cout << "Error: line[" << Exp::linenum << "]: Undeclared function: " << id->toString() << " in: ";
-		this->prettyPrint(cout, 0);
-		cout << endl;
+		errors() << "Error: line[" << Exp::linenum << "]: Undeclared function: " << id->toString() << " in: ";
+		this->prettyPrint(errors(), 0);
+		errors() << endl;
 		semantics = false;
 	}
 	//Chequear argumentos
-	if (args != NULL)
+	if (!args.empty())
 	{
 		//Comparar la cantidad de argumentos a pasar con los que se espera recibir
-		if (functable.getArgCount(id->toString()) != args->size())
+		if (argCount != args.size())
 		{
-			cout << "Error: line[" << Exp::linenum << "]: Number of arguments does not match function signature in: ";
-			this->prettyPrint(cout, 0);
-			cout << "\n";
+			errors() << "Error: line[" << Exp::linenum << "]: Number of arguments does not match function signature in: ";
+			this->prettyPrint(errors(), 0);
+			errors() << "\n";
 			semantics = false;
 		}
 
-		//Comparar los tipos pasados en la llamada
-		int i = 0;
-		for (list<Exp*>::iterator it = args->begin(); it != args->end(); it++)
+		//Comparar los tipos de los parametros uno a uno con los declarados en la firma de la funcion
+		for (int i = 0; i < args.size(); i++)
 		{
-			//Revisar si el parametro es correcto (un id debe estar defindio, una expresion bien formada, etc)
-			(*it)->checkSemantics(stack, functable);
-
-			//Comparar los tipos de los parametros uno a uno con los declarados en la firma de la funcion
-			if (!(functable.checkArgNum(id->toString(), (*it)->getType(stack, functable), i++)))
+			bool match = (func != NULL && func->checkArgNum(args[i]->getType(stack, functable), i));
+			if (!match)
 			{
-				cout << "Error: line[" << Exp::linenum << "]: Parameter\'s " << i << " type does not match the signature of function: " << id->toString() << " in: ";
+				errors() << "Error: line[" << Exp::linenum << "]: Parameter\'s " << i + 1 << " type does not match the signature of function: " << id->toString() << " in: ";
 				semantics = false;
-				this->prettyPrint(cout, 0);
-				cout << endl;
+				this->prettyPrint(errors(), 0);
+				errors() << endl;
 			}
 		}
 	}
 	else
 	{
 		//No pasamos argumentos
-		if (functable.getArgCount(id->toString()) != 0)
+		if (argCount != 0)
 		{
-			cout << "Error: line[" << Exp::linenum << "]: Number of arguments does not match the signature of function in: ";
-			this->prettyPrint(cout, 0);
+			errors() << "Error: line[" << Exp::linenum << "]: Number of arguments does not match the signature of function in: ";
+			this->prettyPrint(errors(), 0);
 			semantics = false;
 		}
 	}
@@ -1354,56 +3760,262 @@ void FCallNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable
 
 Exp* FCallNode::optimize()
 {
-	if (args != NULL)
+	//Optimizar primero los argumentos
+	COptimizeVisitor v;
+	walk(v);
+	return optimizeNode();
+}
+
+Exp* FCallNode::optimizeNode()
+{
+	bool constArgs = true;
+	for (int i = 0; i < args.size(); i++)
+	{
+		constArgs = constArgs && args[i]->isConst();
+	}
+
+	//Una llamada a funcion pura con argumentos constantes se evalua en tiempo de compilacion
+	if (!isStmt && constArgs)
+	{
+		CEvalContext ctx(funcDecls);
+		CValue result;
+		if (this->eval(ctx, result))
+		{
+			Exp* folded = literal(result, Exp::linenum);
+			if (remarks.isEnabled() && folded == NULL)
+			{
+				remark(RK_MISSED, PASS_FOLD, "NotRepresentable", Exp::linenum, remarkText((Exp*)this) + " not evaluated at compile time: its value cannot be written exactly as a literal");
+			}
+			else if (remarks.isEnabled())
+			{
+				remark(RK_PASSED, PASS_FOLD, "CallEvaluated", Exp::linenum, remarkText((Exp*)this) + " evaluated at compile time to " + remarkText(folded));
+			}
+			return folded;
+		}
+	}
+
+	//Las llamadas a funciones del usuario que no se evaluaron, y por que
+	if (!isStmt && remarks.isEnabled())
 	{
-		for (list<Exp *>::iterator it = args->begin(); it != args->end(); it++)
+		map<string, FuncDeclNode*>::iterator it = funcDecls.find(id->toString());
+		if (it != funcDecls.end())
 		{
-			Exp* opt = (*it)->optimize();
-			if (opt != NULL)
+			bool pure = it->second->isPureFunction();
+			if (constArgs && !pure)
+			{
+				remark(RK_MISSED, PASS_FOLD, "CalleeNotPure", Exp::linenum, remarkText((Exp*)this) + " not evaluated at compile time: " + id->toString() + " has side effects");
+			}
+			else if (constArgs)
+			{
+				remark(RK_MISSED, PASS_FOLD, "EvaluationFailed", Exp::linenum, remarkText((Exp*)this) + " not evaluated at compile time: it fails, takes too many steps or, with --stream, was already compiled");
+			}
+			else if (pure)
 			{
-				delete (*it);
-				(*it) = opt;
+				remark(RK_MISSED, PASS_FOLD, "ArgumentsNotConstant", Exp::linenum, remarkText((Exp*)this) + " not evaluated at compile time: its arguments are not constant");
 			}
 		}
 	}
 	return NULL;
 }
 
-void FCallNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+bool FCallNode::isPure(CPilaDeSimbolos& stack, set<string>& calls)
 {
-	if (args != NULL)
+	CPureVisitor v(stack, calls);
+	walk(v);
+	return v.pure;
+}
+
+bool FCallNode::isPureNode(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	calls.insert(id->toString());
+	return true;
+}
+
+bool FCallNode::eval(CEvalContext& ctx, CValue& res)
+{
+	CEvalVisitor v(ctx);
+	walk(v);
+	if (v.failed)
 	{
-		int i = 0;
-		//Compilar los parametros, implica poner en la pila cada expresion
-		for (list<Exp *>::iterator it = args->begin(); it != args->end(); it++)
+		return false;
+	}
+	res = v.values.back();
+	return true;
+}
+
+bool FCallNode::evalNode(CEvalContext& ctx, CValue* operands, CValue& res)
+{
+	if (!ctx.step())
+	{
+		return false;
+	}
+
+	list<CValue> values(operands, operands + args.size());
+
+	string f = id->toString();
+
+	//trunc: f2i de la JVM, satura en los extremos y NaN da 0
+	if (f == "trunc")
+	{
+		if (values.size() != 1 || !values.front().coerce(ET_FLOAT))
+		{
+			return false;
+		}
+		float x = values.front().f;
+		if (x != x)
+		{
+			res = CValue::ofInt(0);
+		}
+		else if (x >= 2147483648.0f)
+		{
+			res = CValue::ofInt(INT_MAX);
+		}
+		else if (x <= -2147483648.0f)
+		{
+			res = CValue::ofInt(INT_MIN);
+		}
+		else
+		{
+			res = CValue::ofInt((int)x);
+		}
+		return true;
+	}
+
+	//toInt: Integer.parseInt, si el string no es valido se deja para tiempo de ejecucion
+	if (f == "toInt")
+	{
+		if (values.size() != 1 || values.front().tipo != ET_STRING)
+		{
+			return false;
+		}
+		string s = values.front().s;
+		size_t i = (s.size() > 0 && (s[0] == '-' || s[0] == '+')) ? 1 : 0;
+		if (i == s.size())
 		{
-			(*it)->compile(out, stack, functable);
-			if (((*it)->getType(stack,functable) == ET_INT) && (functable.getArgNumType(id->toString(), i) == ET_FLOAT))
+			return false;
+		}
+		long long n = 0;
+		for (; i < s.size(); i++)
+		{
+			if (s[i] < '0' || s[i] > '9')
 			{
-				//Si estamos pasando un int y la funcion recibe float, casteamos
-				out << "\ti2f\n";
+				return false;
+			}
+			n = n * 10 + (s[i] - '0');
+			if (n > 2147483648LL)
+			{
+				return false;
 			}
-			++i;
 		}
+		if (s[0] == '-')
+		{
+			n = -n;
+		}
+		if (n > INT_MAX)
+		{
+			return false;
+		}
+		res = CValue::ofInt((int)n);
+		return true;
 	}
-	
-	out << "\tinvokestatic " << className << "/" << id->toString() << "(";
 
-	//Imprimir los tipos para la llamada
-	if (args != NULL)
+	//Funciones del usuario: solo las puras
+	FuncDeclNode* func = ctx.getFunction(f);
+	if (func == NULL || !func->isPureFunction())
+	{
+		return false;
+	}
+	return func->call(ctx, values, res);
+}
+
+EExecResult FCallNode::exec(CEvalContext& ctx)
+{
+	CValue res;
+	return eval(ctx, res) ? EX_NORMAL : EX_FAIL;
+}
+
+Exp* FCallNode::getPrintedNumber()
+{
+	//toString solo recibe float (o int, que se convierte)
+	if (id->toString() != "print" || args.size() != 1)
+	{
+		return NULL;
+	}
+	FCallNode* call = dynamic_cast<FCallNode*>(args[0]);
+	if (call == NULL || call->id->toString() != "toString" || call->args.size() != 1)
+	{
+		return NULL;
+	}
+	return call->args[0];
+}
+
+void FCallNode::compile(ostream& out, CFunctionTable& functable)
+{
+	//print(toString(x)) imprime el float directamente, con print(F) no se crea el String
+	Exp* number = getPrintedNumber();
+	if (number != NULL)
 	{
-		//for (list<Exp *>::iterator it = args->begin(); it != args->end(); it++)
-		for (int i = 0; i < args->size(); i++)
+		if (isStmt)
+		{
+			compileLine(out, Exp::linenum);
+		}
+		number->compile(out, functable);
+		if (number->getType() == ET_INT)
 		{
-			//out << util::compile((*it)->getType(stack, functable));
-			out << util::compile(functable.getArgNumType(id->toString(), i));
+			out << "\ti2f\n";
 		}
+		out << "\tinvokestatic " << className << "/print(F)V\n";
+		return;
+	}
+
+	//Compilar los parametros, implica poner en la pila cada expresion
+	CCompileVisitor v(out, functable);
+	walk(v);
+}
+
+void FCallNode::compilePart(ostream& out, CFunctionTable& functable, int part)
+{
+	//La firma se elige al validar la llamada
+	assert(signature != NULL);
+	if (part == 0 && isStmt)
+	{
+		compileLine(out, Exp::linenum);
+	}
+	if (part > 0 && (args[part - 1]->getType() == ET_INT) && (signature->getArgNum(part - 1) == ET_FLOAT))
+	{
+		//Si estamos pasando un int y la funcion recibe float, casteamos
+		out << "\ti2f\n";
+	}
+	if (part < args.size())
+	{
+		return;
+	}
+
+	//Una funcion impura puede leer o modificar las globales promovidas
+	map<string, FuncDeclNode*>::iterator callee = funcDecls.find(id->toString());
+	bool touchesGlobals = (callee != funcDecls.end() && !callee->second->isPureFunction());
+	if (touchesGlobals)
+	{
+		compileWriteBack(out);
+	}
+
+	out << "\tinvokestatic " << className << "/" << id->toString() << "(";
+
+	//Imprimir los tipos para la llamada
+	for (int i = 0; i < args.size(); i++)
+	{
+		out << util::compile(signature->getArgNum(i));
+	}
+
+	ExpType ret = util::Tipo2ExpType(signature->getReturnType());
+	out << ")" << util::compile(ret) << "\n";
+
+	if (touchesGlobals)
+	{
+		compileReload(out);
 	}
 
-	out << ")" << util::compile(functable.getReturnType(id->toString())) << "\n";
-	
 	//Si la llamada se usa como statement (no se asigna) y devuelve algo, lo quitamos de la pila
-	ExpType ret = functable.getReturnType(id->toString());
 	if (isStmt && ret != ET_VOID && ret != ET_UNKNOWN)
 	{
 		out << "\tpop\n";
@@ -1411,29 +4023,78 @@ void FCallNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& fu
 
 }
 
-ExpType FCallNode::getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
+void FCallNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Como statement la llamada no tiene tipo, por eso se recorren solo los argumentos
+	CResolveVisitor v(stack, functable);
+	for (int i = 0; i < args.size(); i++)
+	{
+		args[i]->walk(v);
+	}
+	if (!isStmt)
+	{
+		getType(stack, functable);
+	}
+}
+
+ExpType FCallNode::computeType(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	//Si este metodo se invoca, la llamada se esta usando como expresion.
 	assert(!isStmt);
-	//return stack.getTipo(id->toString());
-	return functable.getReturnType(id->toString());
+	CFuncArgsType* func = getSignature(stack, functable);
+	return (func != NULL) ? util::Tipo2ExpType(func->getReturnType()) : ET_UNKNOWN;
 }
 
-FCallNode::~FCallNode()
+void FCallNode::scanLoop(CLoopInfo& info)
 {
-	delete id;
-	//los parametros pueden ser null
-	if (args != NULL)
+	CScanLoopVisitor v(info);
+	walk(v);
+}
+
+void FCallNode::scanLoopNode(CLoopInfo& info)
+{
+	if (!isPureCall(id->toString()))
 	{
-		while (!(args->empty()))
+		if (info.inCondition)
 		{
-			delete args->front();
-			args->pop_front();
+			info.condEffects = true;
+		}
+		//Las funciones predefinidas no acceden a las variables globales
+		if (funcDecls.find(id->toString()) != funcDecls.end())
+		{
+			info.globalWrites = true;
 		}
-		delete args;
 	}
 }
 
+void FCallNode::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Solo como statement: como expresion los argumentos los recorre hoistExp
+	for (int i = 0; i < args.size(); i++)
+	{
+		hoistExp(args[i], info, stack, functable);
+	}
+}
+
+bool FCallNode::isInvariant(CLoopInfo& info, CPilaDeSimbolos& stack)
+{
+	CInvariantVisitor v(info, stack);
+	walk(v);
+	return v.invariant[this];
+}
+
+bool FCallNode::isInvariantNode(CLoopInfo& info, CPilaDeSimbolos& stack)
+{
+	//Solo son invariantes las llamadas a funciones puras
+	return isPureCall(id->toString());
+}
+
+FCallNode::~FCallNode()
+{
+	delete id;
+	deleteOperands();
+}
+
 /** Implementacion de la Clase DeclNode **/
 DeclNode::DeclNode(Tipo t, IDNode* id, Exp* exp) 
 { 
@@ -1458,11 +4119,21 @@ void DeclNode::prettyPrint(ostream& out, int depth)
 	out << ";\n";
 }
 
+void DeclNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	id->countNodes(counts);
+	if (exp != NULL)
+	{
+		exp->countNodes(counts);
+	}
+}
+
 void DeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	if (stack.EstaVarEnAlcance(id->toString()))
 	{
-		cout << "Error: line[" << linenum << "]: Identifier redeclared: " << id->toString() << endl;
+		errors() << "Error: line[" << linenum << "]: Identifier redeclared: " << id->toString() << endl;
 		semantics = false;
 	}
 	else
@@ -1483,7 +4154,7 @@ void DeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 			//Si la variable es global, no puede tener inicializacion
 			if (exp != NULL)
 			{
-				cout << "Error: line[" << linenum << "]: Global variable initialization is illegal: " << id->toString() << endl;
+				errors() << "Error: line[" << linenum << "]: Global variable initialization is illegal: " << id->toString() << endl;
 				semantics = false;
 			}
 		}
@@ -1513,7 +4184,7 @@ void DeclNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 			}
 			if (!ok)
 			{
-				cout << "Error: line[" << linenum << "]: Type mismatch in assignment: "; this->prettyPrint(cout, 0); cout << endl;
+				errors() << "Error: line[" << linenum << "]: Type mismatch in assignment: "; this->prettyPrint(errors(), 0); errors() << endl;
 				semantics = false;
 			}
 		}
@@ -1535,29 +4206,107 @@ Exp* DeclNode::optimize()
 	return NULL;
 }
 
-void DeclNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+bool DeclNode::isPure(CPilaDeSimbolos& stack, set<string>& calls)
 {
-	//Nueva definicion
 	stack.NuevaDefinicion(t, id->toString());
+	return (exp == NULL || exp->isPure(stack, calls));
+}
 
-	if (stack.getCurrFuncID() != "__GLOBAL__")
+EExecResult DeclNode::exec(CEvalContext& ctx)
+{
+	if (!ctx.step())
+	{
+		return EX_FAIL;
+	}
+	//Al igual que en la compilacion, la variable se define antes de evaluar la expresion
+	ctx.define(id->toString(), CValue::undefined(util::Tipo2ExpType(t)));
+	if (exp != NULL)
+	{
+		CValue v;
+		if (!exp->eval(ctx, v) || !ctx.assign(id->toString(), v))
+		{
+			return EX_FAIL;
+		}
+	}
+	return EX_NORMAL;
+}
+
+void DeclNode::compile(ostream& out, CFunctionTable& functable)
+{
+	if (id->getSlot() != -1)
 	{
 		//La variable es local
 		if (exp != NULL)
 		{
+			//Las temporales de los ciclos son de la linea del ciclo, no de la suya
+			if (isLocalVar())
+			{
+				compileLine(out, linenum);
+			}
+
 			//Compilar expresion
-			exp->compile(out, stack, functable);
+			exp->compile(out, functable);
+			if (t == TFLOAT && exp->getType() == ET_INT)
+			{
+				out << "\ti2f\n";
+			}
 			//Guardar tope de la pila en id
-			string underscore("_");
-			if (t == TSTRING)
+			const char* underscore = "_";
+			if (t == TSTRING || id->getSlot() > 3)
 			{
-				underscore = string(" ");
+				underscore = " ";
 			}
-			out << "\t" << util::compileInst(util::Tipo2ExpType(t)) << "store" << underscore << stack.GetAsmID(id->toString()) << "\n";
+			out << "\t" << util::compileInst(util::Tipo2ExpType(t)) << "store" << underscore << id->getSlot() << "\n";
 		}
 	}
 }
 
+bool DeclNode::isLocalVar()
+{
+	return id->getSlot() != -1 && id->toString().compare(0, 2, "__") != 0;
+}
+
+void DeclNode::compileVar(ostream& out, int from, int to)
+{
+	out << ".var " << id->getSlot() << " is " << id->toString() << " " << util::compile(util::Tipo2ExpType(t)) << " from Scope" << from << " to Scope" << to << "\n";
+}
+
+void DeclNode::hoistInvariants(CPilaDeSimbolos& stack, CFunctionTable&, ostream&)
+{
+	stack.NuevaDefinicion(t, id->toString());
+}
+
+void DeclNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	//Las globales ya se definieron en checkSemantics
+	if (stack.getCurrFuncID() != "__GLOBAL__")
+	{
+		stack.NuevaDefinicion(t, id->toString());
+	}
+	id->resolve(stack, functable);
+	if (exp != NULL)
+	{
+		exp->resolve(stack, functable);
+	}
+}
+
+void DeclNode::scanLoop(CLoopInfo& info)
+{
+	info.declared.insert(id->toString());
+	if (exp != NULL)
+	{
+		exp->scanLoop(info);
+	}
+}
+
+void DeclNode::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	if (exp != NULL)
+	{
+		hoistExp(exp, info, stack, functable);
+	}
+}
+
 DeclNode::~DeclNode()
 {
 	delete id;
@@ -1584,11 +4333,20 @@ void AssignNode::prettyPrint(ostream& out, int depth)
 	out << " ;\n";
 }
 
+void AssignNode::countNodes(CNodeCounts& counts)
+{
+	Node::countNodes(counts);
+	id->countNodes(counts);
+	exp->countNodes(counts);
+}
+
 void AssignNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
 	//Validar variable declarada
 	if (stack.EstaVarDefinida(id->toString()))
 	{
+		stack.MarcarAsignada(id->toString());
+
 		//Validar expresion
 		exp->checkSemantics(stack, functable);
 		
@@ -1611,13 +4369,13 @@ void AssignNode::checkSemantics(CPilaDeSimbolos& stack, CFunctionTable& functabl
 		}
 		if (!ok)
 		{
-			cout << "Error: line[" << linenum << "]: Type mismatch in assignment: "; this->prettyPrint(cout, 0); cout << endl;
+			errors() << "Error: line[" << linenum << "]: Type mismatch in assignment: "; this->prettyPrint(errors(), 0); errors() << endl;
 			semantics = false;
 		}
 	}
 	else
 	{
-		cout << "Error: linea[" << linenum << "]: Undeclared identifier: " << id->toString() << endl;
+		errors() << "Error: linea[" << linenum << "]: Undeclared identifier: " << id->toString() << endl;
 		semantics = false;
 	}
 }
@@ -1633,22 +4391,50 @@ Exp* AssignNode::optimize()
 	return NULL;
 }
 
-void AssignNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& functable)
+bool AssignNode::isPure(CPilaDeSimbolos& stack, set<string>& calls)
+{
+	bool pure = (stack.GetAsmID(id->toString()) >= 0);
+	return exp->isPure(stack, calls) && pure;
+}
+
+EExecResult AssignNode::exec(CEvalContext& ctx)
+{
+	CValue v;
+	if (!ctx.step() || !exp->eval(ctx, v) || !ctx.assign(id->toString(), v))
+	{
+		return EX_FAIL;
+	}
+	return EX_NORMAL;
+}
+
+void AssignNode::resolve(CPilaDeSimbolos& stack, CFunctionTable& functable)
 {
+	exp->resolve(stack, functable);
+	id->resolve(stack, functable);
+}
+
+void AssignNode::compile(ostream& out, CFunctionTable& functable)
+{
+	compileLine(out, linenum);
+
 	//Compilamos la expresion para que quede en en tope de la pila
-	exp->compile(out, stack, functable);
+	exp->compile(out, functable);
 
-	ExpType t = stack.getTipo(id->toString());
+	ExpType t = id->getType();
+	if (t == ET_FLOAT && exp->getType() == ET_INT)
+	{
+		out << "\ti2f\n";
+	}
 
-	if (stack.GetAsmID(id->toString()) != -1)
+	if (id->getSlot() != -1)
 	{
-		//Guardar tope de la pila en id
-		string underscore("_");
-		if (t == ET_STRING)
+		//Guardar tope de la pila en id (local, o global promovida a local en un ciclo)
+		const char* underscore = "_";
+		if (t == ET_STRING || id->getSlot() > 3)
 		{
-			underscore = string(" ");
+			underscore = " ";
 		}
-		out << "\t" << util::compileInst(t) << "store" << underscore << stack.GetAsmID(id->toString()) << "\n";
+		out << "\t" << util::compileInst(t) << "store" << underscore << id->getSlot() << "\n";
 	}
 	else
 	{
@@ -1656,6 +4442,17 @@ void AssignNode::compile(ostream& out, CPilaDeSimbolos& stack, CFunctionTable& f
 	}
 }
 
+void AssignNode::scanLoop(CLoopInfo& info)
+{
+	info.assigned.insert(id->toString());
+	exp->scanLoop(info);
+}
+
+void AssignNode::hoist(CLoopInfo& info, CPilaDeSimbolos& stack, CFunctionTable& functable)
+{
+	hoistExp(exp, info, stack, functable);
+}
+
 AssignNode::~AssignNode()
 {
 	delete id;
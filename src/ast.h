@@ -28,6 +28,15 @@ using std::list;
 #include <algorithm>
 using std::pair;
 
+#include <map>
+using std::map;
+
+#include <vector>
+using std::vector;
+
+#include <set>
+using std::set;
+
 #include <exception>
 using std::exception;
 
@@ -35,6 +44,11 @@ using std::exception;
 
 #include <cstdlib>
 
+#include <climits>
+
+#include <sstream>
+using std::ostringstream;
+
 #include <fstream>
 using std::ofstream;
 
@@ -46,6 +60,7 @@ using std::ostream;
 #include "tipos.h"
 #include "symbolstack.h"
 #include "functiontable.h"
+#include "evalcontext.h"
 
 //
 //Constantes
@@ -53,6 +68,12 @@ using std::ostream;
 const int tabSize = 4;
 const int maxStack = 10;
 const string className = "Main";
+//Cantidad de resultados que guarda la cache de una funcion memoizada antes de vaciarse
+const int maxMemoEntries = 65536;
+//Tamano del buffer de salida de print en el programa generado
+const int outputBufferSize = 65536;
+//Archivo donde el programa compilado con --instrument escribe sus contadores al terminar
+const string profileFile = "profile.txt";
 //
 //Enums
 //
@@ -60,11 +81,58 @@ typedef enum { OP_PAR, OP_ASSIGN, OP_PLUS, OP_MINUS, OP_TIMES, OP_DIVIDEBY,
 	OP_NOT, OP_EQUALS, OP_NOTEQUAL, OP_OR, OP_AND, OP_LESS, OP_LESSEQ,  
 	OP_GREATER, OP_GREATEREQ} EOperator;
 
+/** Resultado de ejecutar un Statement en el interprete **/
+typedef enum { EX_NORMAL, EX_RETURN, EX_FAIL } EExecResult;
+
 //
 //Clases
 //
 
 class Exp;
+class IDNode;
+class CNodeCounts;
+class DeclNode;
+
+/**
+ * @class CLoopInfo
+ * @brief Datos de un ciclo while que se usan para sacar de el las expresiones invariantes.
+ **/
+class CLoopInfo
+{
+	public:
+		//Variables declaradas dentro del ciclo
+		set<string> declared;
+		//Variables asignadas dentro del ciclo
+		set<string> assigned;
+		//Variables leidas dentro del ciclo
+		set<string> used;
+		//El ciclo invoca funciones que pueden modificar variables globales
+		bool globalWrites;
+		//La condicion invoca funciones con efectos laterales (print, read, etc)
+		bool condEffects;
+		//Se esta recorriendo la condicion, que siempre se evalua, o el cuerpo
+		bool inCondition;
+		//Declaraciones de las variables temporales, se compilan antes del ciclo
+		list<DeclNode*> hoisted;
+
+		CLoopInfo() : globalWrites(false), condEffects(false), inCondition(false) {}
+};
+
+/**
+ * @class CPromotedGlobal
+ * @brief Variable global que se mantiene en una variable local mientras se ejecuta un ciclo.
+ **/
+class CPromotedGlobal
+{
+	public:
+		//Nombre de la global
+		string id;
+		ExpType type;
+		//Variable local que la sustituye
+		int slot;
+		//El ciclo la modifica, hay que volver a guardarla
+		bool written;
+};
 
 /** 
  * @class Node
@@ -78,7 +146,34 @@ class Node
 		virtual void prettyPrint(ostream&, int) = 0;
 		virtual void checkSemantics(CPilaDeSimbolos&, CFunctionTable&) {}
 		virtual Exp* optimize() { return NULL; }
-		virtual void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&) = 0;
+		/**
+		 * Determina si el nodo no lee ni escribe variables globales. Agrega a la lista
+		 * las funciones invocadas, cuya pureza se resuelve luego.
+		 **/
+		virtual bool isPure(CPilaDeSimbolos&, set<string>&) { return true; }
+		/**
+		 * Busca ciclos y mueve antes de ellos las expresiones invariantes. Debe invocarse
+		 * luego de checkSemantics. Escribe en el flujo un reporte de cada ciclo.
+		 **/
+		virtual void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&) {}
+		/** Registra en CLoopInfo las variables declaradas y asignadas y las llamadas del nodo. **/
+		virtual void scanLoop(CLoopInfo&) {}
+		/** Sustituye las subexpresiones invariantes del ciclo por variables temporales. **/
+		virtual void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&) {}
+		/**
+		 * Asocia cada identificador con su variable (numero de local, o -1 si es global) y
+		 * decide que globales se mantienen en locales durante cada ciclo. Es la ultima pasada
+		 * antes de compile, por lo que debe invocarse luego de hoistInvariants.
+		 **/
+		virtual void resolve(CPilaDeSimbolos&, CFunctionTable&) {}
+		/** Genera el codigo jasmin del nodo. Solo usa lo resuelto en las pasadas anteriores. **/
+		virtual void compile(ostream&, CFunctionTable&) = 0;
+		/** Cuenta este nodo y los que contiene, por clase (--time-passes y --trace). **/
+		virtual void countNodes(CNodeCounts&);
+		/** Devuelve la linea del codigo fuente donde termina el nodo. **/
+		int getLine() { return linenum; }
+		/** Cambia la linea del nodo, para los que crean las pasadas en lugar de otro. **/
+		void setLine(int l) { linenum = l; }
 		virtual ~Node() {}
 	
 };
@@ -89,7 +184,9 @@ class Node
  **/
 class Statement : public Node
 {
-	
+	public:
+		/** Ejecuta el Statement en el interprete de tiempo de compilacion. **/
+		virtual EExecResult exec(CEvalContext&) { return EX_FAIL; }
 };
 
 
@@ -104,23 +201,161 @@ class RootNode : public Node
 	public:
 		RootNode();
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
+		/**
+		 * Determina que funciones son puras. Se invoca siempre, antes de las pasadas de
+		 * optimizacion: la generacion de codigo tambien lo necesita.
+		 **/
+		void analyzePurity();
+		/** Marca para memoizar las funciones puras recursivas (pasada memoize). **/
+		void memoizeRecursive();
+		/** Pliega las constantes y evalua las llamadas a funciones puras (pasada fold). **/
 		virtual Exp* optimize();
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		/** Compila los campos estaticos que precisa el codigo generado (caches de memoizacion). **/
+		void compileFields(ostream&);
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
 		void append(Node *);
+		/** Agrega al final las declaraciones de otra raiz, que queda vacia. **/
+		void merge(RootNode*);
+		/** Quita la primera declaracion y la devuelve, o NULL si no quedan. **/
+		Node* takeFirst();
 		~RootNode();
 };
 
+/**
+ * @class CStreamCompiler
+ * @brief Compila cada declaracion apenas se analiza (--stream). La funcion se optimiza, valida
+ * y compila, y se libera su cuerpo: de las funciones anteriores solo quedan las firmas.
+ **/
+class CStreamCompiler
+{
+	private:
+		//Globales y funciones declaradas hasta el momento
+		CPilaDeSimbolos& stack;
+		CFunctionTable& functable;
+		//Globales para el analisis de pureza, que distingue las variables locales de las globales
+		CPilaDeSimbolos purity;
+		//Funciones ya compiladas, sin cuerpo
+		RootNode signatures;
+		//Fuente, fuente optimizado, reporte de ciclos y metodos compilados
+		ostream& out;
+		ostream& opt;
+		ostream& licm;
+		ostream& methods;
+	public:
+		CStreamCompiler(CPilaDeSimbolos&, CFunctionTable&, ostream&, ostream&, ostream&, ostream&);
+		/** Procesa la siguiente declaracion del fuente. Si es una variable global, la libera. **/
+		void add(Node*);
+		/** Compila el inicializador estatico de la clase, luego de la ultima declaracion. **/
+		void finish();
+};
+
+/**
+ * @class CExpVisitor
+ * @brief Pasada sobre una expresion que se recorre sin recursion, con Exp::walk.
+ **/
+class CExpVisitor
+{
+	public:
+		/** Se invoca al llegar a un nodo. Si devuelve false no se recorren sus operandos ni se invoca leave. **/
+		virtual bool enter(Exp*) { return true; }
+		/** Se invoca entre dos operandos del nodo; el entero es el indice del operando que sigue. **/
+		virtual void between(Exp*, int) {}
+		/** Se invoca luego de recorrer todos los operandos del nodo. **/
+		virtual void leave(Exp*) {}
+		virtual ~CExpVisitor() {}
+};
+
 /**
  * @class Exp
  * @brief Clase abstracta padre de todas las expresiones. Extiende Node.
  **/
 class Exp : public Node
 {
+	private:
+		//Tipo ya calculado de la expresion
+		ExpType cachedType;
+		bool typeResolved;
+		//Recorrido que calcula los tipos de abajo hacia arriba
+		friend class CTypeVisitor;
+		void resolveTypes(CPilaDeSimbolos&, CFunctionTable&);
+	protected:
+		/** Calcula el tipo de la expresion. Solo se invoca una vez por nodo, con los operandos ya calculados. **/
+		virtual ExpType computeType(CPilaDeSimbolos&, CFunctionTable&) = 0;
+		/** Borra los operandos sin recursion; lo invocan los destructores de BinExp y UnExp. **/
+		void deleteOperands();
 	public:
-		virtual ExpType getType(CPilaDeSimbolos&, CFunctionTable&) = 0;
+		Exp() : cachedType(ET_UNKNOWN), typeResolved(false) {}
+
+		/**
+		 * Devuelve el tipo de la expresion. Se calcula la primera vez que se pide, durante el
+		 * analisis semantico, y queda guardado en el nodo para las pasadas siguientes.
+		 **/
+		ExpType getType(CPilaDeSimbolos& stack, CFunctionTable& functable)
+		{
+			if (!typeResolved)
+			{
+				resolveTypes(stack, functable);
+			}
+			return cachedType;
+		}
+		/** Devuelve el tipo ya calculado por checkSemantics o resolve. **/
+		ExpType getType() { return cachedType; }
+		/** Las expresiones calculan su tipo, por si el nodo se creo luego del analisis semantico. **/
+		void resolve(CPilaDeSimbolos& stack, CFunctionTable& functable) { getType(stack, functable); }
 		/** Evalua si una expresion es un numero, de asi serlo, devuelve true y el numero al que evalua. **/		 
 		virtual bool isNum(float&) { return false; }
+		/** Determina si la expresion es una constante literal. **/
+		virtual bool isConst() { return false; }
+		/** Evalua la expresion en el interprete de tiempo de compilacion. **/
+		virtual bool eval(CEvalContext&, CValue&) { return false; }
+		/** Si la expresion es una variable (posiblemente entre parentesis) devuelve su identificador, sino NULL. **/
+		virtual IDNode* getVar() { return NULL; }
+		/** Determina si la expresion tiene el mismo valor en todas las iteraciones del ciclo. **/
+		virtual bool isInvariant(CLoopInfo&, CPilaDeSimbolos&) { return false; }
+		/** Determina si evaluar la expresion puede lanzar una excepcion o no terminar. **/
+		virtual bool canThrow(CPilaDeSimbolos&, CFunctionTable&) { return false; }
+
+		//
+		//Recorrido sin recursion. Las expresiones encadenadas (a + b + c ...) pueden tener
+		//millones de operandos, por lo que BinExp y UnExp implementan cada pasada como un
+		//CExpVisitor que invoca las versiones "Node" o "Part" de abajo, que solo tratan al nodo.
+		//Las llamadas tambien se recorren asi, con los argumentos como operandos. En las hojas
+		//(variables y constantes) esas versiones invocan la pasada completa.
+		//
+
+		/** Cantidad de operandos que recorre walk. **/
+		virtual int getOperandCount() { return 0; }
+		/** Devuelve el operando i, por referencia para poder sustituirlo. **/
+		virtual Exp*& getOperand(int);
+		/** Recorre la expresion con una pila explicita. **/
+		void walk(CExpVisitor&);
+
+		/** Imprime la parte del nodo previa al operando i, o la final si i es la cantidad de operandos. **/
+		virtual void prettyPrintPart(ostream& out, int depth, int) { prettyPrint(out, depth); }
+		/** Compila la parte del nodo previa al operando i, o la final si i es la cantidad de operandos. **/
+		virtual void compilePart(ostream& out, CFunctionTable& functable, int) { compile(out, functable); }
+		/** Valida el nodo, con los operandos ya validados. **/
+		virtual void checkNode(CPilaDeSimbolos& stack, CFunctionTable& functable) { checkSemantics(stack, functable); }
+		/** Optimiza el nodo, con los operandos ya optimizados. Devuelve el nodo que lo sustituye o NULL. **/
+		virtual Exp* optimizeNode() { return optimize(); }
+		/** Evalua el nodo a partir de los valores de sus operandos. **/
+		virtual bool evalNode(CEvalContext& ctx, CValue*, CValue& res) { return eval(ctx, res); }
+		/** Determina si el nodo en si no accede a variables globales, sin contar los operandos. **/
+		virtual bool isPureNode(CPilaDeSimbolos& stack, set<string>& calls) { return isPure(stack, calls); }
+		/** Registra en CLoopInfo lo que hace el nodo en si, sin los operandos. **/
+		virtual void scanLoopNode(CLoopInfo& info) { scanLoop(info); }
+		/** Determina si el nodo en si es invariante, suponiendo que sus operandos lo son. **/
+		virtual bool isInvariantNode(CLoopInfo& info, CPilaDeSimbolos& stack) { return isInvariant(info, stack); }
+		/** Determina si el nodo en si puede lanzar una excepcion, sin contar los operandos. **/
+		virtual bool canThrowNode(CPilaDeSimbolos& stack, CFunctionTable& functable) { return canThrow(stack, functable); }
+		/** Cuenta solo el nodo, sin los operandos. **/
+		virtual void countNode(CNodeCounts& counts) { Node::countNodes(counts); }
+		/** Cuenta la expresion completa. **/
+		void countNodes(CNodeCounts&);
 };
 
 /** 
@@ -136,9 +371,16 @@ class StmtIf : public Statement
 	public:
 		StmtIf(Exp *, Statement*, Statement*);
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		virtual Exp* optimize();
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		EExecResult exec(CEvalContext&);
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 		~StmtIf();
 };
 
@@ -151,12 +393,27 @@ class StmtWhile : public Statement
 	private:
 		Exp *exp;
 		Statement *stmt;
+		//Variables temporales con las expresiones invariantes, se evaluan antes del ciclo
+		list<DeclNode*> prologue;
+		//Variables globales que se mantienen en locales durante el ciclo
+		list<CPromotedGlobal> promoted;
 	public:
 		StmtWhile(Exp *, Statement *);
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		virtual Exp* optimize();
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		EExecResult exec(CEvalContext&);
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		/**
+		 * Las globales que usa el ciclo se promueven a locales si no hay otro ciclo
+		 * que las contenga. Los ciclos anidados quedan dentro de la misma region.
+		 **/
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 		~StmtWhile();
 };
 
@@ -168,12 +425,22 @@ class StmtReturn : public Statement
 {
 	private:
 		Exp *exp;
+		//Tipo de retorno de la funcion que contiene al return
+		ExpType funcType;
+		//El return termina el programa
+		bool inMain;
 	public:
 		StmtReturn(Exp *);
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		virtual Exp* optimize();
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		EExecResult exec(CEvalContext&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 		~StmtReturn();
 };
 
@@ -212,9 +479,9 @@ class BinExp : public Exp
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		
 		/**
-		 * Devuelve el tipo de esta expresion.
+		 * Calcula el tipo de esta expresion.
 		 **/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 
 		/**
 		 * Calcula a que tipo se evaluara la expresion
@@ -234,10 +501,43 @@ class BinExp : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);		
+		void compile(ostream&, CFunctionTable&);		
+
+		/**
+		 * Determina si la expresion no accede a variables globales.
+		 **/
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		/**
+		 * Evalua la expresion con la semantica de la JVM.
+		 **/
+		bool eval(CEvalContext&, CValue&);
+
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&);
+
+		bool canThrow(CPilaDeSimbolos&, CFunctionTable&);
+
+		int getOperandCount() { return 2; }
+		Exp*& getOperand(int i) { return (i == 0) ? exp1 : exp2; }
+		void prettyPrintPart(ostream&, int, int);
+		void compilePart(ostream&, CFunctionTable&, int);
+		void checkNode(CPilaDeSimbolos&, CFunctionTable&);
+		Exp* optimizeNode();
+		bool evalNode(CEvalContext&, CValue*, CValue&);
+		bool isPureNode(CPilaDeSimbolos&, set<string>&) { return true; }
+		void scanLoopNode(CLoopInfo&) {}
+		bool isInvariantNode(CLoopInfo&, CPilaDeSimbolos&) { return true; }
+		/**
+		 * La division entera puede lanzar ArithmeticException y la concatenacion
+		 * falla con un string no inicializado.
+		 **/
+		bool canThrowNode(CPilaDeSimbolos&, CFunctionTable&);
 
 		/**
 		 * Destructor.
@@ -275,9 +575,9 @@ class UnExp : public Exp
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		
 		/**
-		 * Devuelve el tipo de esta expresion
+		 * Calcula el tipo de esta expresion
 		 **/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 
 		/**
 		 * Determina si esta expresion evalua a un numero
@@ -292,10 +592,41 @@ class UnExp : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		/**
+		 * Determina si la expresion no accede a variables globales.
+		 **/
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		/**
+		 * Evalua la expresion en el interprete.
+		 **/
+		bool eval(CEvalContext&, CValue&);
+
+		/** Los parentesis no cambian la variable que se accede. **/
+		IDNode* getVar();
+
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&);
+		bool canThrow(CPilaDeSimbolos&, CFunctionTable&);
+
+		int getOperandCount() { return 1; }
+		Exp*& getOperand(int) { return exp; }
+		void prettyPrintPart(ostream&, int, int);
+		void compilePart(ostream&, CFunctionTable&, int);
+		void checkNode(CPilaDeSimbolos&, CFunctionTable&);
+		Exp* optimizeNode();
+		bool evalNode(CEvalContext&, CValue*, CValue&);
+		bool isPureNode(CPilaDeSimbolos&, set<string>&) { return true; }
+		void scanLoopNode(CLoopInfo&) {}
+		bool isInvariantNode(CLoopInfo&, CPilaDeSimbolos&) { return true; }
+		bool canThrowNode(CPilaDeSimbolos&, CFunctionTable&) { return false; }
 
 		/** Destructor **/
 		~UnExp();
@@ -309,12 +640,15 @@ class IDNode : public Exp
 {
 	private:
 		string id;
+		//Numero de variable local, -1 si es global (igual que CPilaDeSimbolos::GetAsmID)
+		int slot;
 	public:
 		/** 
 		 * Crea una nueva instancia de IDNode.
 		 * @param char* string conteniendo el nombre del identificador.
 		**/
 		IDNode(char *);
+		IDNode(string);
 		/**
 		 * Imprime este nodo.
 		 * @param ostream flujo de salida donde imprimir.
@@ -330,10 +664,35 @@ class IDNode : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		/**
+		 * Un identificador es puro solo si refiere a una variable local.
+		 **/
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		/**
+		 * Devuelve el valor de la variable en el interprete.
+		 **/
+		bool eval(CEvalContext&, CValue&);
+
+		IDNode* getVar() { return this; }
+		void scanLoop(CLoopInfo&);
+
+		/**
+		 * Asocia el identificador con la variable visible en la pila. Las globales
+		 * promovidas en el ciclo que se esta resolviendo se asocian con su local.
+		 **/
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		int getSlot() { return slot; }
+
+		/**
+		 * Una variable es invariante si no se declara ni se asigna en el ciclo. Una global
+		 * ademas requiere que el ciclo no invoque funciones que puedan modificarla.
+		 **/
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&);
 
 		/**
 		 * Devuelve una representacion literal de este identificador.
@@ -342,9 +701,9 @@ class IDNode : public Exp
 		string toString() { return id; }
 
 		/**
-		 * Devuelve el tipo de esta expresion.
+		 * Calcula el tipo de esta expresion.
 		 **/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 };
 
 /**
@@ -380,13 +739,16 @@ class IntConst : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isConst() { return true; }
+		bool eval(CEvalContext&, CValue&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&) { return true; }
 
 		/** Devuelve el tipo asociado a esta constante, TINT.**/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 };
 
 /**
@@ -422,13 +784,16 @@ class FloatConst : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isConst() { return true; }
+		bool eval(CEvalContext&, CValue&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&) { return true; }
 
 		/** Devuelve el tipo asociado a esta constante, TFLOAT.**/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 };
 
 /**
@@ -459,13 +824,16 @@ class StringConst : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isConst() { return true; }
+		bool eval(CEvalContext&, CValue&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&) { return true; }
 
 		/** Devuelve el tipo asociado a esta constante, TSTRING. **/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 };
 
 /**
@@ -496,15 +864,18 @@ class BoolConst : public Exp
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isConst() { return true; }
+		bool eval(CEvalContext&, CValue&);
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&) { return true; }
 
 		/**
 		 * Devuelve el tipo asociado a esta constante, TBOOL.
 		**/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 };
 
 /**
@@ -521,16 +892,22 @@ class ArgsNode : public Node
 		list< pair<Tipo,IDNode*> >* getList();
 
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
 
 		list<Tipo> getTypeList();
 
@@ -550,6 +927,7 @@ class BodyNode : public Statement
 		BodyNode(list<Statement*>*);
 
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 
@@ -561,10 +939,18 @@ class BodyNode : public Statement
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		EExecResult exec(CEvalContext&);
+
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 
 		~BodyNode();
 };
@@ -584,13 +970,48 @@ class FuncDeclNode : public Node
 		ArgsNode* args;
 		//Cuerpo
 		BodyNode* body;
+		//Resultado del analisis de pureza
+		bool pure;
+		//Funciones invocadas desde el cuerpo
+		set<string> callees;
+		//Indica si las llamadas pasan por una cache de resultados
+		bool memoize;
+		//Globales y funciones declaradas antes que esta funcion (visibles desde su cuerpo)
+		int visibleGlobals;
+		int visibleFunctions;
+		//Lineas de los ciclos, en el orden de sus contadores de --instrument (el 0 es el de las llamadas)
+		vector<int> loopLines;
+		//Linea del nombre de la funcion (linenum es la de la llave que cierra el cuerpo)
+		int declLine;
+
+		/** Compila el metodo que consulta la cache antes de invocar al cuerpo de la funcion. **/
+		void compileMemoWrapper(ostream&, CFunctionTable&);
+		/** Compila los metodos de la funcion (compile registra ademas el intervalo para --trace). **/
+		void compileMethods(ostream&, CFunctionTable&);
+		/** Cantidad de nodos de la funcion. **/
+		long countAll();
 	public:
 		FuncDeclNode(Tipo, IDNode*, ArgsNode*, BodyNode*);
 
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 
+		/**
+		 * Registra la firma de la funcion y recuerda que globales y funciones estan declaradas
+		 * hasta este punto. Es la parte de checkSemantics que depende del orden de las declaraciones.
+		 **/
+		void declare(CPilaDeSimbolos&, CFunctionTable&);
+
+		/**
+		 * Valida los argumentos y el cuerpo. Puede hacerse en paralelo con otras funciones,
+		 * con una pila que tenga solo las globales visibles (ver declare).
+		 **/
+		void checkBody(CPilaDeSimbolos&, CFunctionTable&);
+		int getVisibleGlobals() { return visibleGlobals; }
+		int getVisibleFunctions() { return visibleFunctions; }
+
 		/**
 		 * Envia a optimizar a sus hijos
 		 **/
@@ -599,10 +1020,54 @@ class FuncDeclNode : public Node
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+
+		/**
+		 * Analiza el cuerpo de la funcion: determina si accede a variables globales
+		 * y recuerda las funciones que invoca.
+		 **/
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+
+		/**
+		 * Ejecuta la funcion en el interprete con los argumentos dados.
+		 **/
+		bool call(CEvalContext&, list<CValue>&, CValue&);
+
+		string getId() { return id->toString(); }
+		int getDeclLine() { return declLine; }
+		void setDeclLine(int l) { declLine = l; }
+		set<string>& getCallees() { return callees; }
+		bool isPureFunction() { return pure; }
+		void setPure(bool b) { pure = b; }
+		bool isMemoized() { return memoize; }
+		void setMemoize(bool b) { memoize = b; }
+		bool returnsVoid() { return retType == TVOID; }
+
+		/** Compila la cache y los contadores de aciertos y fallos de una funcion memoizada. **/
+		void compileFields(ostream&);
+		/** Compila la inicializacion de la cache (dentro de <clinit>). **/
+		void compileStaticInit(ostream&);
+		/** Compila la impresion de los contadores de la cache. **/
+		void compileMemoStats(ostream&);
+
+		/** Registra un ciclo de la funcion, en la linea dada, y devuelve el numero de su contador. **/
+		int addLoopCounter(int);
+		/** Compila el incremento del contador dado de la funcion (--instrument). **/
+		void compileCounter(ostream&, int);
+		/** Compila la escritura de los contadores de la funcion en el perfil, abierto en la variable 0. **/
+		void compileProfile(ostream&);
+
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+
+		/**
+		 * Libera el cuerpo y los argumentos de una funcion ya compilada. Quedan el nombre y
+		 * los datos que precisan las llamadas (pureza, memoizacion); el interprete ya no
+		 * puede ejecutarla.
+		 **/
+		void release();
 
 		~FuncDeclNode();
 		
@@ -620,7 +1085,14 @@ class FCallNode : public Exp, public Statement
 	private:
 		IDNode* id;
 		bool isStmt;
-		list<Exp*>* args;
+		//Argumentos, vacio si no se pasan; walk los recorre como operandos
+		vector<Exp*> args;
+		/** Firma de la funcion invocada que corresponde a los argumentos, se busca una sola vez **/
+		CFuncArgsType* signature;
+		/** Devuelve la firma de la funcion invocada, NULL si no esta declarada. **/
+		CFuncArgsType* getSignature(CPilaDeSimbolos&, CFunctionTable&);
+		/** Si la llamada es print(toString(x)) devuelve x, sino NULL. **/
+		Exp* getPrintedNumber();
 	public:
 		/** 
 		 * Crea una nueva intancia de FCallNode.
@@ -629,6 +1101,9 @@ class FCallNode : public Exp, public Statement
 		 * @param bool determina si esta funcion esta siendo utilizada como Statement para el PrettyPrint.
 		 **/
 		FCallNode(IDNode*, list<Exp*>*, bool isStmt = true);
+		/** Cuenta la llamada y su identificador; los argumentos los cuenta walk. **/
+		void countNode(CNodeCounts&);
+		void countNodes(CNodeCounts& counts) { Exp::countNodes(counts); }
 		/**
 		 * Imprime este nodo.
 		 * @param ostream flujo de salida donde imprimir.
@@ -646,19 +1121,45 @@ class FCallNode : public Exp, public Statement
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
 		/**
 		 * Cambia el uso, como Statement o Expresion
 		 **/
 		void setStmt(bool);
 		/**
-		 * Devuelve el tipo de esta llamada (sera el tipo de retorno de la funcion invocada).
+		 * Calcula el tipo de esta llamada (sera el tipo de retorno de la funcion invocada).
 		 **/
-		ExpType getType(CPilaDeSimbolos&, CFunctionTable&);
+		ExpType computeType(CPilaDeSimbolos&, CFunctionTable&);
 
+		/**
+		 * Los argumentos deben ser puros; la funcion invocada se agrega a la lista.
+		 **/
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		/**
+		 * Invoca la funcion en el interprete. Solo se admiten funciones puras.
+		 **/
+		bool eval(CEvalContext&, CValue&);
+		EExecResult exec(CEvalContext&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
+		/** Solo son invariantes las llamadas a funciones puras. **/
+		bool isInvariant(CLoopInfo&, CPilaDeSimbolos&);
+		bool canThrow(CPilaDeSimbolos&, CFunctionTable&) { return true; }
+
+		int getOperandCount() { return args.size(); }
+		Exp*& getOperand(int i) { return args[i]; }
+		void prettyPrintPart(ostream&, int, int);
+		void compilePart(ostream&, CFunctionTable&, int);
+		void checkNode(CPilaDeSimbolos&, CFunctionTable&);
+		Exp* optimizeNode();
+		bool evalNode(CEvalContext&, CValue*, CValue&);
+		/** Agrega la funcion invocada a la lista. **/
+		bool isPureNode(CPilaDeSimbolos&, set<string>&);
+		void scanLoopNode(CLoopInfo&);
+		bool isInvariantNode(CLoopInfo&, CPilaDeSimbolos&);
 		/**
 		 * Devuelve el identificador asociado
 		 **/
@@ -683,6 +1184,7 @@ class DeclNode : public Statement
 	public:
 		DeclNode(Tipo, IDNode*, Exp*);
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		/**
 		 * Optimiza la expresion.
@@ -691,10 +1193,19 @@ class DeclNode : public Statement
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		/** Indica si declara una variable local del programa, y no una temporal del compilador. **/
+		bool isLocalVar();
+		/** Compila la directiva .var de la variable, visible entre las dos etiquetas Scope. **/
+		void compileVar(ostream&, int, int);
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		EExecResult exec(CEvalContext&);
+		void hoistInvariants(CPilaDeSimbolos&, CFunctionTable&, ostream&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 		~DeclNode();
 
 };
@@ -707,6 +1218,7 @@ class AssignNode : public Statement
 	public:
 		AssignNode(IDNode*, Exp*);
 		void prettyPrint(ostream&, int);
+		void countNodes(CNodeCounts&);
 		void checkSemantics(CPilaDeSimbolos&, CFunctionTable&);
 		/**
 		 * Aplica constant folding a la expresion.
@@ -715,10 +1227,14 @@ class AssignNode : public Statement
 		/**
 		 * Compila esta expresion a jasmin.
 		 * @param ostream flujo de salida.
-		 * @param CPilaDeSimbolos pila de simbolos.
 		 * @param CFunctionTable tabla de funciones.
 		 **/
-		void compile(ostream&, CPilaDeSimbolos&, CFunctionTable&);
+		void compile(ostream&, CFunctionTable&);
+		bool isPure(CPilaDeSimbolos&, set<string>&);
+		EExecResult exec(CEvalContext&);
+		void resolve(CPilaDeSimbolos&, CFunctionTable&);
+		void scanLoop(CLoopInfo&);
+		void hoist(CLoopInfo&, CPilaDeSimbolos&, CFunctionTable&);
 		~AssignNode();
 };
 
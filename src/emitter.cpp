@@ -0,0 +1,210 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "emitter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/** Escribe todas las partes, aunque el sistema acepte menos bytes en cada llamada. **/
+static bool writeAll(int fd, const char* part[2], streamsize size[2])
+{
+	int first = 0;
+	while (first < 2)
+	{
+		if (size[first] == 0)
+		{
+			first++;
+			continue;
+		}
+#ifdef _WIN32
+		//Sin writev, de a una parte
+		int written = _write(fd, part[first], size[first]);
+#else
+		struct iovec parts[2];
+		for (int i = first; i < 2; i++)
+		{
+			parts[i].iov_base = (void*)part[i];
+			parts[i].iov_len = size[i];
+		}
+		ssize_t written = writev(fd, parts + first, 2 - first);
+#endif
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		while (written > 0)
+		{
+			streamsize step = (written < size[first]) ? written : size[first];
+			part[first] += step;
+			size[first] -= step;
+			written -= step;
+			if (size[first] == 0)
+			{
+				first++;
+			}
+		}
+	}
+	return true;
+}
+
+CEmitBuffer::CEmitBuffer() : fd(-1), owner(false), failed(false), memory(false), buffer(emitBufferSize)
+{
+	setp(&buffer[0], &buffer[0] + buffer.size());
+}
+
+CEmitBuffer::CEmitBuffer(int size) : fd(-1), owner(false), failed(false), memory(true), buffer(size)
+{
+	setp(&buffer[0], &buffer[0] + buffer.size());
+}
+
+CEmitBuffer::~CEmitBuffer()
+{
+	close();
+}
+
+bool CEmitBuffer::flush(const char* extra, streamsize size)
+{
+	const char* part[2] = { pbase(), extra };
+	streamsize sizes[2] = { pptr() - pbase(), size };
+	setp(&buffer[0], &buffer[0] + buffer.size());
+	//Sin archivo abierto lo escrito se descarta, como con un ofstream sin abrir
+	if (fd == -1 || failed)
+	{
+		return false;
+	}
+	if (!writeAll(fd, part, sizes))
+	{
+		failed = true;
+	}
+	return !failed;
+}
+
+void CEmitBuffer::grow(streamsize size)
+{
+	streamsize used = pptr() - pbase();
+	streamsize capacity = buffer.size() * 2;
+	if (capacity < used + size)
+	{
+		capacity = used + size;
+	}
+	buffer.resize(capacity);
+	setp(&buffer[0], &buffer[0] + buffer.size());
+	pbump(used);
+}
+
+int CEmitBuffer::overflow(int c)
+{
+	if (memory)
+	{
+		grow(1);
+	}
+	else
+	{
+		flush(NULL, 0);
+	}
+	if (c != EOF)
+	{
+		*pptr() = c;
+		pbump(1);
+	}
+	return failed ? EOF : 0;
+}
+
+streamsize CEmitBuffer::xsputn(const char* s, streamsize n)
+{
+	if (n <= epptr() - pptr())
+	{
+		memcpy(pptr(), s, n);
+		pbump(n);
+		return n;
+	}
+	if (memory)
+	{
+		grow(n);
+		memcpy(pptr(), s, n);
+		pbump(n);
+		return n;
+	}
+	//No entra en lo que queda del bloque: se manda junto con el bloque
+	return flush(s, n) ? n : 0;
+}
+
+int CEmitBuffer::sync()
+{
+	//En memoria no hay nada que escribir (ej. un endl)
+	if (memory)
+	{
+		return 0;
+	}
+	return flush(NULL, 0) ? 0 : -1;
+}
+
+bool CEmitBuffer::open(const char* path)
+{
+	close();
+#ifdef _WIN32
+	fd = _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+	fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+	owner = true;
+	failed = (fd == -1);
+	return !failed;
+}
+
+void CEmitBuffer::attach(int descriptor)
+{
+	close();
+	fd = descriptor;
+	owner = false;
+	failed = false;
+}
+
+bool CEmitBuffer::close()
+{
+	if (fd == -1)
+	{
+		setp(&buffer[0], &buffer[0] + buffer.size());
+		return !failed;
+	}
+	bool ok = flush(NULL, 0);
+	if (owner)
+	{
+#ifdef _WIN32
+		_close(fd);
+#else
+		::close(fd);
+#endif
+	}
+	fd = -1;
+	return ok;
+}
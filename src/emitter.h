@@ -0,0 +1,102 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <ostream>
+using std::ostream;
+using std::streambuf;
+using std::streamsize;
+
+#include <vector>
+using std::vector;
+
+//Tamano del buffer de salida de cada CEmitter
+const int emitBufferSize = 1 << 20;
+
+/**
+ * @class CEmitBuffer
+ * @brief Buffer de salida hacia un descriptor de archivo. Junta todo lo que se escribe en un
+ * unico bloque que se reusa, y lo manda al archivo con una sola llamada a write cuando se llena.
+ * Un texto que no entra en lo que queda del bloque se manda junto con el bloque en un writev,
+ * sin copiarlo. Creado con un tamano, el buffer queda en memoria: el bloque crece en lugar de
+ * escribirse, y se reusa luego de leerlo (ej. el codigo de un metodo compilado en paralelo).
+ **/
+class CEmitBuffer : public streambuf
+{
+	private:
+		int fd;
+		bool owner;
+		bool failed;
+		bool memory;
+		vector<char> buffer;
+
+		/** Escribe el contenido del bloque seguido de size bytes de extra. **/
+		bool flush(const char* extra, streamsize size);
+		/** Agranda el bloque en memoria para que entren size bytes mas. **/
+		void grow(streamsize size);
+	protected:
+		int overflow(int c);
+		streamsize xsputn(const char* s, streamsize n);
+		int sync();
+	public:
+		CEmitBuffer();
+		/** Buffer en memoria, con un bloque inicial de size bytes. **/
+		explicit CEmitBuffer(int size);
+		~CEmitBuffer();
+
+		/** Contenido del buffer en memoria. **/
+		const char* getData() { return pbase(); }
+		streamsize getSize() { return pptr() - pbase(); }
+		/** Vacia el buffer en memoria para reusarlo, sin liberar el bloque. **/
+		void reset() { setp(&buffer[0], &buffer[0] + buffer.size()); }
+
+		/** Crea (o vacia) el archivo path. Devuelve false si no se pudo abrir. **/
+		bool open(const char* path);
+
+		/** Escribe en un descriptor ya abierto, que no se cierra al terminar (ej: 1 para stdout). **/
+		void attach(int descriptor);
+
+		/** Escribe lo que queda en el bloque y cierra el archivo. Devuelve false si hubo errores. **/
+		bool close();
+};
+
+/**
+ * @class CEmitter
+ * @brief ostream sobre un CEmitBuffer, para escribir el codigo generado en un archivo.
+ **/
+class CEmitter : public ostream
+{
+	private:
+		CEmitBuffer buf;
+	public:
+		CEmitter() : ostream(NULL) { rdbuf(&buf); }
+		/** Escribe en memoria, ver CEmitBuffer. **/
+		explicit CEmitter(int size) : ostream(NULL), buf(size) { rdbuf(&buf); }
+
+		bool open(const char* path) { return buf.open(path); }
+		void attach(int descriptor) { buf.attach(descriptor); }
+		bool close() { return buf.close(); }
+
+		const char* getData() { return buf.getData(); }
+		streamsize getSize() { return buf.getSize(); }
+		void reset() { buf.reset(); }
+};
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "evalcontext.h"
+
+//Marcas en la lista de variables
+static const string marcaAlcance("__ALCANCE__");
+static const string marcaFuncion("__FUNCION__");
+
+/** Implementacion de la Clase CValue **/
+CValue CValue::ofInt(int i)
+{
+	CValue v;
+	v.tipo = ET_INT;
+	v.i = i;
+	return v;
+}
+
+CValue CValue::ofFloat(float f)
+{
+	CValue v;
+	v.tipo = ET_FLOAT;
+	v.f = f;
+	return v;
+}
+
+CValue CValue::ofBool(bool b)
+{
+	CValue v;
+	v.tipo = ET_BOOL;
+	v.b = b;
+	return v;
+}
+
+CValue CValue::ofString(string s)
+{
+	CValue v;
+	v.tipo = ET_STRING;
+	v.s = s;
+	return v;
+}
+
+CValue CValue::undefined(ExpType t)
+{
+	CValue v;
+	v.tipo = t;
+	v.vacio = true;
+	return v;
+}
+
+bool CValue::coerce(ExpType t)
+{
+	if (tipo == t)
+	{
+		return true;
+	}
+	//Unica conversion implicita de L+: int a float
+	if (tipo == ET_INT && t == ET_FLOAT)
+	{
+		tipo = ET_FLOAT;
+		f = (float)i;
+		return true;
+	}
+	return false;
+}
+
+/** Implementacion de la Clase CEvalContext **/
+CEvalContext::CEvalContext(map<string, FuncDeclNode*>& funcs) : m_funcs(funcs)
+{
+	m_steps = 0;
+	m_depth = 0;
+}
+
+bool CEvalContext::step()
+{
+	return (++m_steps <= maxEvalSteps);
+}
+
+bool CEvalContext::enterCall()
+{
+	if (m_depth >= maxEvalDepth)
+	{
+		return false;
+	}
+	++m_depth;
+	m_vars.push_front(make_pair(marcaFuncion, CValue()));
+	return true;
+}
+
+void CEvalContext::leaveCall()
+{
+	--m_depth;
+	while (!m_vars.empty())
+	{
+		bool fin = (m_vars.front().first == marcaFuncion);
+		m_vars.pop_front();
+		if (fin)
+		{
+			break;
+		}
+	}
+}
+
+void CEvalContext::NuevoAlcance()
+{
+	m_vars.push_front(make_pair(marcaAlcance, CValue()));
+}
+
+void CEvalContext::FinAlcance()
+{
+	while (!m_vars.empty())
+	{
+		bool fin = (m_vars.front().first == marcaAlcance);
+		m_vars.pop_front();
+		if (fin)
+		{
+			break;
+		}
+	}
+}
+
+void CEvalContext::define(string id, CValue v)
+{
+	m_vars.push_front(make_pair(id, v));
+}
+
+bool CEvalContext::lookup(string id, CValue& v)
+{
+	//Solo se ven las variables de la funcion actual
+	for (list< pair<string, CValue> >::iterator it = m_vars.begin(); it != m_vars.end() && it->first != marcaFuncion; it++)
+	{
+		if (it->first == id)
+		{
+			//Una variable sin inicializar no tiene valor
+			if (it->second.vacio)
+			{
+				return false;
+			}
+			v = it->second;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CEvalContext::assign(string id, CValue v)
+{
+	for (list< pair<string, CValue> >::iterator it = m_vars.begin(); it != m_vars.end() && it->first != marcaFuncion; it++)
+	{
+		if (it->first == id)
+		{
+			if (!v.coerce(it->second.tipo))
+			{
+				return false;
+			}
+			it->second = v;
+			return true;
+		}
+	}
+	return false;
+}
+
+FuncDeclNode* CEvalContext::getFunction(string id)
+{
+	map<string, FuncDeclNode*>::iterator it = m_funcs.find(id);
+	if (it == m_funcs.end())
+	{
+		return NULL;
+	}
+	return it->second;
+}
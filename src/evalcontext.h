@@ -0,0 +1,109 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVALCONTEXT_H
+#define EVALCONTEXT_H
+
+#include <string>
+using std::string;
+
+#include <list>
+using std::list;
+
+#include <map>
+using std::map;
+
+#include <algorithm>
+using std::pair;
+
+#include "tipos.h"
+
+class FuncDeclNode;
+
+//
+//Limites del interprete en tiempo de compilacion
+//
+const int maxEvalSteps = 1000000;
+const int maxEvalDepth = 256;
+
+/**
+ * @class CValue
+ * @brief Valor calculado por el interprete en tiempo de compilacion.
+ **/
+class CValue
+{
+	public:
+		ExpType tipo;
+		int i;
+		float f;
+		bool b;
+		string s;
+		//Variable declarada pero sin inicializar
+		bool vacio;
+
+		CValue() : tipo(ET_UNKNOWN), i(0), f(0), b(false), vacio(false) {}
+
+		static CValue ofInt(int);
+		static CValue ofFloat(float);
+		static CValue ofBool(bool);
+		static CValue ofString(string);
+		static CValue undefined(ExpType);
+
+		/** Convierte el valor al tipo dado con las reglas de asignacion de L+ (int -> float). **/
+		bool coerce(ExpType);
+};
+
+/**
+ * @class CEvalContext
+ * @brief Estado del interprete: variables, limites de pasos y de recursion.
+ **/
+class CEvalContext
+{
+	private:
+		//Variables definidas, con marcas de alcance y de funcion al igual que CPilaDeSimbolos
+		list< pair<string, CValue> > m_vars;
+		//Funciones del programa
+		map<string, FuncDeclNode*>& m_funcs;
+		int m_steps;
+		int m_depth;
+	public:
+		//Valor del ultimo return ejecutado
+		CValue retVal;
+
+		CEvalContext(map<string, FuncDeclNode*>&);
+
+		/** Cuenta un paso de ejecucion. Devuelve false si se excedio el limite. **/
+		bool step();
+
+		/** Entra a una funcion. Devuelve false si se excedio la profundidad de recursion. **/
+		bool enterCall();
+		void leaveCall();
+
+		void NuevoAlcance();
+		void FinAlcance();
+
+		void define(string, CValue);
+		bool lookup(string, CValue&);
+		/** Asigna una variable convirtiendo el valor al tipo con el que fue declarada. **/
+		bool assign(string, CValue);
+
+		/** Devuelve la declaracion de una funcion, o NULL si no existe. **/
+		FuncDeclNode* getFunction(string);
+};
+
+#endif
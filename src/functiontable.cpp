@@ -17,13 +17,23 @@
  */
 
 #include "functiontable.h"
+#include "stats.h"
+
+#include <pthread.h>
+
+//Funciones visibles para las consultas del hilo actual, -1 si son todas
+static __thread int visible = -1;
+
+//Protege los datos que se registran por funcion mientras se validan o compilan en paralelo
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
 //		Tipo ret;
 //		list<Tipo> args;
 
-CFuncArgsType::CFuncArgsType(Tipo t, list<Tipo> largs)
+CFuncArgsType::CFuncArgsType(Tipo t, list<Tipo> largs, int o)
 {
 	ret = t;
+	order = o;
 	locals = 0; //El minimo de variables locales para jasmin es 1
 	for (list<Tipo>::iterator it = largs.begin(); it != largs.end(); it++)
 	{
@@ -59,78 +69,148 @@ ExpType CFuncArgsType::getArgNum(int i)
 	return ET_UNKNOWN;
 }
 
-bool CFunctionTable::addFunction(Tipo t, string f, list<Tipo> args)
+void CFuncArgsType::incLocals()
+{
+	pthread_mutex_lock(&mutex);
+	++locals;
+	pthread_mutex_unlock(&mutex);
+}
+
+CFuncArgsType* CFunctionTable::find(const string& f)
+{
+	countStat(compileStats.functionLookups);
+	unordered_map<string, list<CFuncArgsType> >::iterator it = table.find(f);
+	if (it == table.end() || (visible >= 0 && it->second.front().getOrder() >= visible))
+	{
+		return NULL;
+	}
+	return &it->second.front();
+}
+
+void CFunctionTable::setVisible(int count)
+{
+	visible = count;
+}
+
+bool CFunctionTable::addFunction(Tipo t, const string& f, list<Tipo> args)
 {
 	if (table.find(f) == table.end())
 	{
-		table.insert( make_pair( f, CFuncArgsType (t, args)) );
+		table[f].push_back(CFuncArgsType(t, args, count++));
 		return true;
 	}
 	return false;
 }
 
-bool CFunctionTable::isDeclared(string f)
+void CFunctionTable::addOverload(Tipo t, const string& f, list<Tipo> args)
+{
+	table[f].push_back(CFuncArgsType(t, args, count++));
+}
+
+CFuncArgsType* CFunctionTable::resolve(const string& f, const vector<ExpType>& types)
+{
+	CFuncArgsType* first = find(f);
+	if (first == NULL)
+	{
+		return NULL;
+	}
+	//Se invoca desde varios hilos durante checkSemantics: find no modifica la tabla
+	unordered_map<string, list<CFuncArgsType> >::iterator overloads = table.find(f);
+	CFuncArgsType* converted = NULL;
+	for (list<CFuncArgsType>::iterator it = overloads->second.begin(); it != overloads->second.end(); it++)
+	{
+		if (it->getArgCount() != types.size() || (visible >= 0 && it->getOrder() >= visible))
+		{
+			continue;
+		}
+		bool exact = true;
+		bool accepted = true;
+		for (int i = 0; i < types.size(); i++)
+		{
+			exact = exact && (it->getArgNum(i) == types[i]);
+			accepted = accepted && it->checkArgNum(types[i], i);
+		}
+		if (exact)
+		{
+			return &*it;
+		}
+		if (accepted && converted == NULL)
+		{
+			converted = &*it;
+		}
+	}
+	return (converted != NULL) ? converted : first;
+}
+
+bool CFunctionTable::isDeclared(const string& f)
 {
-	return (table.find(f) != table.end());
+	return (find(f) != NULL);
 }
 
-bool CFunctionTable::checkArgNum(string f, ExpType t, int i)
+bool CFunctionTable::checkArgNum(const string& f, ExpType t, int i)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		return table[f].checkArgNum(t, i);
+		return func->checkArgNum(t, i);
 	}
 	return false;
 }
 
-int CFunctionTable::getArgCount(string f)
+int CFunctionTable::getArgCount(const string& f)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		return table[f].getArgCount();
+		return func->getArgCount();
 	}
 	return -1; //error
 }
 
-ExpType CFunctionTable::getArgNumType(string f, int i)
+ExpType CFunctionTable::getArgNumType(const string& f, int i)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		return table[f].getArgNum(i);
+		return func->getArgNum(i);
 	}
 	return ET_UNKNOWN;
 }
 
-ExpType CFunctionTable::getReturnType(string f)
+ExpType CFunctionTable::getReturnType(const string& f)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		return Tipo2ExpType(table[f].getReturnType());
+		return Tipo2ExpType(func->getReturnType());
 	}
 	return ET_UNKNOWN;
 }
 
-void CFunctionTable::setLocals(string f, int locals)
+void CFunctionTable::setLocals(const string& f, int locals)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		table[f].setLocals(locals);
+		func->setLocals(locals);
 	}
 }
 
-void CFunctionTable::incLocals(string f)
+void CFunctionTable::incLocals(const string& f)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		table[f].incLocals();
+		func->incLocals();
 	}
 }
 
-int CFunctionTable::getLocals(string f)
+int CFunctionTable::getLocals(const string& f)
 {
-	if (table.find(f) != table.end())
+	CFuncArgsType* func = find(f);
+	if (func != NULL)
 	{
-		return table[f].getLocals();
+		return func->getLocals();
 	}
 	return -1; //Error, no existe tal funcion.
 }
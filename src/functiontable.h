@@ -19,8 +19,13 @@
 #ifndef CFUNCTIONTABLE_H
 #define CFUNCTIONTABLE_H
 
-#include <map>
-using std::map;
+#if __cplusplus >= 201103L
+#include <unordered_map>
+using std::unordered_map;
+#else
+#include <tr1/unordered_map>
+using std::tr1::unordered_map;
+#endif
 
 #include <string>
 using std::string;
@@ -40,51 +45,75 @@ class CFuncArgsType
 		Tipo ret;
 		vector<Tipo> args;
 		int locals;
+		//Posicion de la funcion en el orden de declaracion
+		int order;
 	public:
-		CFuncArgsType(Tipo, list<Tipo>);
+		CFuncArgsType(Tipo, list<Tipo>, int);
 		CFuncArgsType() {}
 		Tipo getReturnType();
 		int getArgCount() { return args.size(); }
 		bool checkArgNum(ExpType, int);
 		ExpType getArgNum(int);
 		void setLocals(int l) { locals = l; }
-		void incLocals() { ++locals; }
+		void incLocals();
 		int getLocals() { return locals; }
+		int getOrder() { return order; }
 };
 
 class CFunctionTable
 {
 
 	private:
-		map<string, CFuncArgsType> table;
+		//Firmas de cada nombre, en orden de declaracion. Solo las funciones predefinidas pueden
+		//tener mas de una (ej: print). Las firmas no cambian de lugar, se pueden guardar punteros.
+		unordered_map<string, list<CFuncArgsType> > table;
+		//Cantidad de firmas registradas
+		int count;
+		//Busca la primera firma visible de una funcion, NULL si no esta declarada
+		CFuncArgsType* find(const string&);
 	public:
-		CFunctionTable() {}
+		CFunctionTable() : count(0) {}
 		//Agrega una declaracion de funcion
-		bool addFunction(Tipo, string, list<Tipo>);
+		bool addFunction(Tipo, const string&, list<Tipo>);
+
+		//Agrega otra firma a una funcion predefinida
+		void addOverload(Tipo, const string&, list<Tipo>);
+
+		//Elige la firma de una funcion para una llamada con argumentos de los tipos dados: la que
+		//coincide exactamente, sino la primera que los acepta convirtiendo int a float, sino la
+		//primera firma (para reportar los errores contra ella). NULL si no esta declarada.
+		CFuncArgsType* resolve(const string&, const vector<ExpType>&);
 
 		//Consulta si un identificador corresponde a una funcion declarada
-		bool isDeclared(string);
+		bool isDeclared(const string&);
 
 		//Verifica si dos tipos coinciden
-		bool checkArgNum(string, ExpType, int);
+		bool checkArgNum(const string&, ExpType, int);
 
 		//Devuelte el tipo de algun argumento
-		ExpType getArgNumType(string, int);
+		ExpType getArgNumType(const string&, int);
 
 		//Devuelve el tipo de retorno de una funcion
-		ExpType getReturnType(string);
+		ExpType getReturnType(const string&);
 
 		//Devuelve el numero de argumentos que una funcion espera recibir
-		int getArgCount(string);
+		int getArgCount(const string&);
 
 		//Establece el numero de variables locales de una funcion. (en desuso).
-		void setLocals(string, int);
+		void setLocals(const string&, int);
 
 		//Incrementa el numero de variables locales de una funcion
-		void incLocals(string);
+		void incLocals(const string&);
 
 		//Devuelve en numero de variables locales de una funcion
-		int getLocals(string);
+		int getLocals(const string&);
+
+		//Devuelve la cantidad de firmas declaradas
+		int size() { return count; }
+
+		//Limita las consultas del hilo actual a las primeras funciones declaradas (-1 sin limite),
+		//para validar cada funcion en paralelo viendo solo las declaradas antes que ella
+		static void setVisible(int);
 
 };
 
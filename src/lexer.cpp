@@ -0,0 +1,326 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Tokenizer para L+ escrito a mano, alternativo al generado por flex (samp.l).
+ * Lee directamente del fuente (mapeado en memoria por main), sin copiarlo: los
+ * identificadores y las cadenas son partes del fuente. Los espacios, los comentarios
+ * y los finales de cadena se buscan de a 16 bytes con SSE2 o de a 32 con AVX2.
+ * Tiene que dar exactamente los mismos tokens que samp.l (ver bench/lexdiff.sh).
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "samp.tab.hpp"
+#include "ast.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+//Cada hilo analiza su parte del fuente con su propio contador de lineas
+__thread int line = 1;
+
+/**
+ * @class CLexer
+ * @brief Estado del scanner de una parte del fuente.
+ **/
+struct CLexer
+{
+	//Proximo caracter a leer y fin de la parte
+	const char* p;
+	const char* end;
+	//Donde empieza la linea actual, para calcular las columnas. Como en samp.l, solo
+	//los saltos de linea que se cuentan en line empiezan una linea nueva.
+	const char* lineStart;
+	CParseChunk* chunk;
+};
+
+yyscan_t openScanner(CParseChunk* chunk)
+{
+	CLexer* lexer = new CLexer;
+	lexer->p = chunk->text;
+	lexer->end = chunk->text + chunk->size;
+	lexer->lineStart = chunk->text - (chunk->firstColumn - 1);
+	lexer->chunk = chunk;
+	line = chunk->firstLine;
+	return lexer;
+}
+
+void closeScanner(yyscan_t scanner)
+{
+	delete (CLexer*)scanner;
+}
+
+/** Cuenta los saltos de linea de una mascara de bits y recuerda donde empieza la ultima linea. **/
+static inline void countNewlines(CLexer* lexer, const char* block, unsigned int newlines)
+{
+	if (newlines != 0)
+	{
+		line += __builtin_popcount(newlines);
+		lexer->lineStart = block + (31 - __builtin_clz(newlines)) + 1;
+	}
+}
+
+/** Saltea espacios, tabuladores y saltos de linea, contando los saltos de linea. **/
+static const char* skipBlanks(CLexer* lexer, const char* p, const char* end)
+{
+#ifdef __AVX2__
+	const __m256i space32 = _mm256_set1_epi8(' ');
+	const __m256i tab32 = _mm256_set1_epi8('\t');
+	const __m256i newline32 = _mm256_set1_epi8('\n');
+	while (end - p >= 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)p);
+		unsigned int newlines = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline32));
+		unsigned int blanks = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, space32),
+			_mm256_cmpeq_epi8(block, tab32))) | newlines;
+		if (blanks != 0xFFFFFFFFu)
+		{
+			int n = __builtin_ctz(~blanks);
+			countNewlines(lexer, p, newlines & ((1u << n) - 1));
+			return p + n;
+		}
+		countNewlines(lexer, p, newlines);
+		p += 32;
+	}
+#endif
+#ifdef __SSE2__
+	const __m128i space16 = _mm_set1_epi8(' ');
+	const __m128i tab16 = _mm_set1_epi8('\t');
+	const __m128i newline16 = _mm_set1_epi8('\n');
+	while (end - p >= 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)p);
+		unsigned int newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline16));
+		unsigned int blanks = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, space16),
+			_mm_cmpeq_epi8(block, tab16))) | newlines;
+		if (blanks != 0xFFFF)
+		{
+			int n = __builtin_ctz(~blanks);
+			countNewlines(lexer, p, newlines & ((1u << n) - 1));
+			return p + n;
+		}
+		countNewlines(lexer, p, newlines);
+		p += 16;
+	}
+#endif
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\n'))
+	{
+		if (*p == '\n')
+		{
+			line++;
+			lexer->lineStart = p + 1;
+		}
+		p++;
+	}
+	return p;
+}
+
+/** Busca el caracter c desde p. Devuelve end si no esta. **/
+static const char* findChar(const char* p, const char* end, char c)
+{
+#ifdef __AVX2__
+	const __m256i c32 = _mm256_set1_epi8(c);
+	while (end - p >= 32)
+	{
+		unsigned int found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), c32));
+		if (found != 0)
+		{
+			return p + __builtin_ctz(found);
+		}
+		p += 32;
+	}
+#endif
+#ifdef __SSE2__
+	const __m128i c16 = _mm_set1_epi8(c);
+	while (end - p >= 16)
+	{
+		unsigned int found = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), c16));
+		if (found != 0)
+		{
+			return p + __builtin_ctz(found);
+		}
+		p += 16;
+	}
+#endif
+	while (p < end && *p != c)
+	{
+		p++;
+	}
+	return p;
+}
+
+static inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static inline bool isLetter(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/** Palabras reservadas. Solo son tales si el identificador es exactamente la palabra. **/
+static int keyword(const char* text, int size, YYSTYPE* yylval)
+{
+	switch (size)
+	{
+		case 2:
+			if (memcmp(text, "if", 2) == 0) return IF;
+			break;
+		case 3:
+			if (memcmp(text, "int", 3) == 0) return INT;
+			break;
+		case 4:
+			if (memcmp(text, "true", 4) == 0) { yylval->bval = true; return TRUE; }
+			if (memcmp(text, "bool", 4) == 0) return BOOL;
+			if (memcmp(text, "void", 4) == 0) return VOID;
+			if (memcmp(text, "else", 4) == 0) return ELSE;
+			break;
+		case 5:
+			if (memcmp(text, "false", 5) == 0) { yylval->bval = false; return FALSE; }
+			if (memcmp(text, "float", 5) == 0) return FLOAT;
+			if (memcmp(text, "while", 5) == 0) return WHILE;
+			break;
+		case 6:
+			if (memcmp(text, "string", 6) == 0) return STRING;
+			if (memcmp(text, "return", 6) == 0) return RETURN;
+			break;
+	}
+	return 0;
+}
+
+int yylex(YYSTYPE* yylval, YYLTYPE* yylloc, yyscan_t scanner)
+{
+	CLexer* lexer = (CLexer*)scanner;
+	const char* end = lexer->end;
+	while (true)
+	{
+		const char* p = skipBlanks(lexer, lexer->p, end);
+		if (p == end)
+		{
+			lexer->p = p;
+			return 0;
+		}
+
+		const char* start = p;
+		char c = *p++;
+		int token = 0;
+		if (isLetter(c) || c == '_')
+		{
+			//Como en samp.l, el '_' solo puede ir al principio
+			while (p < end && (isLetter(*p) || isDigit(*p)))
+			{
+				p++;
+			}
+			token = keyword(start, p - start, yylval);
+			if (token == 0)
+			{
+				yylval->slice.text = start;
+				yylval->slice.size = p - start;
+				token = ID;
+			}
+		}
+		else if (isDigit(c))
+		{
+			while (p < end && isDigit(*p))
+			{
+				p++;
+			}
+			token = NUM;
+			if (end - p >= 2 && *p == '.' && isDigit(p[1]))
+			{
+				p++;
+				while (p < end && isDigit(*p))
+				{
+					p++;
+				}
+				token = REAL;
+			}
+			//El fuente no termina en '\0', se copia el numero para convertirlo
+			string number(start, p - start);
+			if (token == NUM)
+			{
+				yylval->ival = atoi(number.c_str());
+			}
+			else
+			{
+				yylval->fval = atof(number.c_str());
+			}
+		}
+		else if (c == '"')
+		{
+			//Una comilla sin cerrar no es una cadena, es un caracter no reconocido
+			const char* close = findChar(p, end, '"');
+			if (close != end)
+			{
+				p = close + 1;
+				yylval->slice.text = start;
+				yylval->slice.size = p - start;
+				token = STRING;
+			}
+		}
+		else if (c == '/' && p < end && *p == '/')
+		{
+			//Comentario hasta el fin de linea. El salto de linea se cuenta en la proxima vuelta.
+			lexer->p = findChar(p, end, '\n');
+			continue;
+		}
+		else
+		{
+			char next = (p < end) ? *p : '\0';
+			switch (c)
+			{
+				case '!': if (next == '=') { p++; token = NOTEQUAL; } else token = NOT; break;
+				case '=': if (next == '=') { p++; token = EQUALS; } else token = ASSIGN; break;
+				case '<': if (next == '=') { p++; token = LESSEQ; } else token = LESS; break;
+				case '>': if (next == '=') { p++; token = GREATEREQ; } else token = GREATER; break;
+				case '|': if (next == '|') { p++; token = OR; } break;
+				case '&': if (next == '&') { p++; token = AND; } break;
+				case '*': token = TIMES; break;
+				case '/': token = DIVIDEBY; break;
+				case '+': token = PLUS; break;
+				case '-': token = MINUS; break;
+				case ',': token = COLON; break;
+				case ';': token = SEMICOLON; break;
+				case '(': token = LPAR; break;
+				case ')': token = RPAR; break;
+				case '{': token = LCURL; break;
+				case '}': token = RCURL; break;
+			}
+		}
+
+		if (token == 0)
+		{
+			//Como en samp.l, un '\0' no se ve en el mensaje
+			lexer->chunk->messages += string("Caracter no reconocido: ") + string(start, c != '\0') + "\n";
+			lexer->p = start + 1;
+			continue;
+		}
+
+		yylloc->first_line = yylloc->last_line = line;
+		yylloc->first_column = start - lexer->lineStart + 1;
+		yylloc->last_column = p - lexer->lineStart;
+		lexer->p = p;
+		return token;
+	}
+}
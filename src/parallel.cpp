@@ -0,0 +1,136 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * Hilos de parallelFor: se crean en la primera llamada que los necesita y quedan esperando el
+ * trabajo de las siguientes, hasta que termina el programa. Cada trabajo es una generacion:
+ * todos los hilos del pool participan una vez en cada una, aunque no les toque ningun indice.
+ **/
+struct CThreadPool
+{
+	pthread_mutex_t mutex;
+	//Hay un trabajo nuevo
+	pthread_cond_t start;
+	//Termino el ultimo hilo del pool que trabajaba
+	pthread_cond_t done;
+	CParallelTask* task;
+	int count;
+	int next;
+	int generation;
+	//Hilos del pool que todavia no terminaron la generacion actual
+	int busy;
+	int size;
+};
+
+static CThreadPool pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL, 0, 0, 0, 0, 0 };
+
+//Indica si el hilo esta ejecutando una tarea: un parallelFor desde una tarea no usa el pool
+static __thread bool inTask = false;
+
+/** Ejecuta los indices que quedan del trabajo actual. Se llama y vuelve con el mutex tomado. **/
+static void runTasks()
+{
+	while (pool.next < pool.count)
+	{
+		int i = pool.next++;
+		pthread_mutex_unlock(&pool.mutex);
+		inTask = true;
+		pool.task->run(i);
+		inTask = false;
+		pthread_mutex_lock(&pool.mutex);
+	}
+}
+
+static void* worker(void*)
+{
+	int seen = 0;
+	pthread_mutex_lock(&pool.mutex);
+	while (true)
+	{
+		while (pool.generation == seen)
+		{
+			pthread_cond_wait(&pool.start, &pool.mutex);
+		}
+		seen = pool.generation;
+		runTasks();
+		if (--pool.busy == 0)
+		{
+			pthread_cond_signal(&pool.done);
+		}
+	}
+	return NULL;
+}
+
+int getThreadCount()
+{
+	int threads = jobs;
+#ifdef _SC_NPROCESSORS_ONLN
+	if (threads <= 0)
+	{
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+#endif
+	return (threads > 0) ? threads : 1;
+}
+
+void parallelFor(int count, CParallelTask& task)
+{
+	int threads = getThreadCount();
+	if (threads > count)
+	{
+		threads = count;
+	}
+	if (threads <= 1 || inTask)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			task.run(i);
+		}
+		return;
+	}
+
+	pthread_mutex_lock(&pool.mutex);
+	for (; pool.size < threads - 1; pool.size++)
+	{
+		pthread_t id;
+		if (pthread_create(&id, NULL, worker, NULL) != 0)
+		{
+			break;
+		}
+		pthread_detach(id);
+	}
+	pool.task = &task;
+	pool.count = count;
+	pool.next = 0;
+	pool.busy = pool.size;
+	pool.generation++;
+	pthread_cond_broadcast(&pool.start);
+
+	//El hilo actual tambien trabaja, y espera a los demas antes de que task deje de existir
+	runTasks();
+	while (pool.busy > 0)
+	{
+		pthread_cond_wait(&pool.done, &pool.mutex);
+	}
+	pthread_mutex_unlock(&pool.mutex);
+}
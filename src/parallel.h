@@ -0,0 +1,42 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+//Cantidad de hilos pedida con --jobs, 0 para usar uno por procesador
+extern int jobs;
+
+/**
+ * @class CParallelTask
+ * @brief Trabajo independiente para cada uno de los elementos de una lista (ver parallelFor).
+ **/
+class CParallelTask
+{
+	public:
+		virtual void run(int) = 0;
+		virtual ~CParallelTask() {}
+};
+
+/** Devuelve la cantidad de hilos a usar: la pedida con --jobs, o uno por procesador. **/
+int getThreadCount();
+
+/** Ejecuta task.run(i) para i de 0 a count - 1, repartiendo los indices entre los hilos. **/
+void parallelFor(int count, CParallelTask& task);
+
+#endif
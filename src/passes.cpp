@@ -0,0 +1,170 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "passes.h"
+#include "ast.h"
+#include "stats.h"
+
+#include <cstdio>
+
+#include <iostream>
+using std::endl;
+
+CPassManager passes;
+
+/** Memoizacion de las funciones puras recursivas (ver RootNode::memoizeRecursive). **/
+static bool runMemoize(CPassContext& ctx)
+{
+	ctx.root->memoizeRecursive();
+	return false;
+}
+
+/** Plegado de constantes y evaluacion de llamadas a funciones puras con argumentos constantes. **/
+static bool runFold(CPassContext& ctx)
+{
+	ctx.root->optimize();
+	return false;
+}
+
+static bool runLicm(CPassContext& ctx)
+{
+	ctx.root->hoistInvariants(*ctx.stack, *ctx.functable, *ctx.licm);
+	return false;
+}
+
+/**
+ * @class CPassInfo
+ * @brief Descripcion de una pasada: nombre para -f y -fno-, etapa, nivel desde el que se
+ * habilita, si se repite hasta no producir cambios, etapa de --time-passes y funcion (NULL
+ * si la aplica la etapa en la que esta).
+ **/
+struct CPassInfo
+{
+	const char* name;
+	EPassStage stage;
+	int level;
+	bool fixpoint;
+	EPhase phase;
+	bool (*run)(CPassContext&);
+	const char* description;
+};
+
+//En el orden de EPass, que es el orden en que se ejecutan
+static const CPassInfo passInfo[PASS_COUNT] =
+{
+	{ "memoize", STAGE_AST, 3, false, PH_OPTIMIZE, runMemoize, "cache the results of pure recursive functions" },
+	{ "fold", STAGE_AST, 1, false, PH_OPTIMIZE, runFold, "fold constant expressions and calls to pure functions with constant arguments" },
+	{ "licm", STAGE_CHECKED, 2, false, PH_LICM, runLicm, "move loop invariant expressions out of while loops" },
+	{ "promote", STAGE_RESOLVE, 2, false, PH_RESOLVE, NULL, "keep the globals used in a loop in local variables" },
+	{ "peephole", STAGE_IR, 1, false, PH_PEEPHOLE, NULL, "replace a store followed by a load of the same variable with dup and store" }
+};
+
+//Titulos de las etapas para --print-passes, en el orden de EPassStage
+static const char* stageNames[] =
+{
+	"AST passes, before the semantic checks",
+	"Checked AST passes",
+	"Identifier resolution",
+	"Jasmin code passes"
+};
+
+CPassManager::CPassManager() : level(defaultOptLevel)
+{
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		forced[i] = false;
+		enabled[i] = (passInfo[i].level <= level);
+	}
+}
+
+bool CPassManager::setLevel(int l)
+{
+	if (l < 0 || l > 3)
+	{
+		return false;
+	}
+	level = l;
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		if (!forced[i])
+		{
+			enabled[i] = (passInfo[i].level <= level);
+		}
+	}
+	return true;
+}
+
+bool CPassManager::setEnabled(const string& name, bool on)
+{
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		if (name == passInfo[i].name)
+		{
+			enabled[i] = on;
+			forced[i] = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* CPassManager::getName(EPass pass)
+{
+	return passInfo[pass].name;
+}
+
+void CPassManager::run(EPassStage stage, CPassContext& ctx)
+{
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		const CPassInfo& info = passInfo[i];
+		if (info.stage != stage || info.run == NULL || !enabled[i])
+		{
+			continue;
+		}
+		compileStats.enter(info.phase);
+		int iterations = 1;
+		while (info.run(ctx) && info.fixpoint && iterations < maxPassIterations)
+		{
+			iterations++;
+		}
+	}
+}
+
+void CPassManager::print(ostream& out)
+{
+	out << "Optimization level: -O" << level << endl;
+	int stage = -1;
+	for (int i = 0; i < PASS_COUNT; i++)
+	{
+		const CPassInfo& info = passInfo[i];
+		if (info.stage != stage)
+		{
+			stage = info.stage;
+			out << stageNames[stage] << ":" << endl;
+		}
+		char text[64];
+		sprintf(text, "  %-12s -O%d  %-5s", info.name, info.level, enabled[i] ? "on" : "off");
+		out << text << info.description;
+		if (info.fixpoint)
+		{
+			out << " (repeated until nothing changes)";
+		}
+		out << endl;
+	}
+}
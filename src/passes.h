@@ -0,0 +1,115 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PASSES_H
+#define PASSES_H
+
+#include <ostream>
+using std::ostream;
+
+#include <string>
+using std::string;
+
+class RootNode;
+class CPilaDeSimbolos;
+class CFunctionTable;
+
+/** Pasadas de optimizacion, en el orden en que se ejecutan. **/
+enum EPass
+{
+	PASS_MEMOIZE,
+	PASS_FOLD,
+	PASS_LICM,
+	PASS_PROMOTE,
+	PASS_PEEPHOLE,
+	PASS_COUNT
+};
+
+/** Momento de la compilacion en el que corre cada pasada. **/
+enum EPassStage
+{
+	//Sobre el arbol leido, antes del chequeo semantico
+	STAGE_AST,
+	//Sobre el arbol ya validado, antes de resolver los identificadores
+	STAGE_CHECKED,
+	//Dentro de la resolucion de identificadores
+	STAGE_RESOLVE,
+	//Sobre el codigo jasmin, a medida que se genera
+	STAGE_IR
+};
+
+/** Nivel de optimizacion por defecto (-O2). **/
+const int defaultOptLevel = 2;
+
+/** Maximo de veces que se repite una pasada que se ejecuta hasta no producir cambios. **/
+const int maxPassIterations = 100;
+
+/**
+ * @class CPassContext
+ * @brief Lo que reciben las pasadas sobre el arbol: la raiz, las tablas que deja el chequeo
+ * semantico (solo desde STAGE_CHECKED) y el reporte de --licm-report.
+ **/
+struct CPassContext
+{
+	RootNode* root;
+	CPilaDeSimbolos* stack;
+	CFunctionTable* functable;
+	ostream* licm;
+};
+
+/**
+ * @class CPassManager
+ * @brief Pasadas de optimizacion habilitadas (-O0 a -O3, -f<pasada> y -fno-<pasada>) y su
+ * ejecucion en orden. Cada nivel habilita las pasadas del anterior y algunas mas; -f y -fno-
+ * habilitan o deshabilitan una pasada sin importar el nivel. Las pasadas sin funcion propia
+ * (promote y peephole) las aplica la etapa en la que estan, si estan habilitadas.
+ **/
+class CPassManager
+{
+	private:
+		int level;
+		bool enabled[PASS_COUNT];
+		//Pasadas elegidas con -f o -fno-, que no cambian con el nivel
+		bool forced[PASS_COUNT];
+	public:
+		CPassManager();
+
+		/** Elige el nivel de optimizacion, de 0 a 3. Devuelve false si no es valido. **/
+		bool setLevel(int l);
+		int getLevel() { return level; }
+
+		/** Habilita o deshabilita una pasada por su nombre. Devuelve false si no existe. **/
+		bool setEnabled(const string& name, bool on);
+		bool isEnabled(EPass pass) { return enabled[pass]; }
+
+		/** Nombre de la pasada, el de -f y -fno-. **/
+		const char* getName(EPass pass);
+
+		/**
+		 * Ejecuta en orden las pasadas habilitadas de stage que tienen funcion propia. Las que
+		 * llegan a un punto fijo se repiten hasta que no cambian el arbol.
+		 **/
+		void run(EPassStage stage, CPassContext& ctx);
+
+		/** Imprime las pasadas de cada etapa, en orden, y si estan habilitadas (--print-passes). **/
+		void print(ostream& out);
+};
+
+extern CPassManager passes;
+
+#endif
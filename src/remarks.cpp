@@ -0,0 +1,135 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "remarks.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fstream>
+using std::ofstream;
+using std::ostream;
+
+CRemarks remarks;
+
+//Nombres de los tipos en el YAML, en el orden de ERemarkKind
+static const char* kindNames[] = { "Passed", "Missed", "Analysis" };
+
+/** Orden del archivo: por linea, y en la misma linea en el orden en que se registraron. **/
+static bool remarkBefore(const CRemark& a, const CRemark& b)
+{
+	if (a.line != b.line)
+	{
+		return a.line < b.line;
+	}
+	return a.order < b.order;
+}
+
+/** Misma observacion, registrada mas de una vez (una pasada que se repite). **/
+static bool sameRemark(const CRemark& a, const CRemark& b)
+{
+	return a.kind == b.kind && a.line == b.line && strcmp(a.pass, b.pass) == 0 && strcmp(a.name, b.name) == 0 && a.function == b.function && a.message == b.message;
+}
+
+/** Escribe s como string de YAML entre comillas simples, donde solo se duplica la comilla. **/
+static void writeYamlString(ostream& out, const string& s)
+{
+	out << '\'';
+	for (unsigned int i = 0; i < s.size(); i++)
+	{
+		if (s[i] == '\'')
+		{
+			out << '\'';
+		}
+		out << s[i];
+	}
+	out << '\'';
+}
+
+CRemarks::CRemarks() : enabled(false)
+{
+	pthread_mutex_init(&mutex, NULL);
+}
+
+CRemarks::~CRemarks()
+{
+	pthread_mutex_destroy(&mutex);
+}
+
+void CRemarks::open(const char* p)
+{
+	path = p;
+	enabled = true;
+}
+
+void CRemarks::add(ERemarkKind kind, const char* pass, const char* name, const string& function, int line, const string& message)
+{
+	if (!enabled)
+	{
+		return;
+	}
+	CRemark r;
+	r.kind = kind;
+	r.pass = pass;
+	r.name = name;
+	r.function = function;
+	r.line = line;
+	r.message = message;
+
+	pthread_mutex_lock(&mutex);
+	r.order = remarks.size();
+	remarks.push_back(r);
+	pthread_mutex_unlock(&mutex);
+}
+
+bool CRemarks::write(const char* source)
+{
+	if (!enabled)
+	{
+		return true;
+	}
+	enabled = false;
+
+	//Las funciones se procesan en paralelo: el orden de llegada solo es el mismo dentro de
+	//cada funcion, cuyas lineas no se mezclan con las de otras
+	std::stable_sort(remarks.begin(), remarks.end(), remarkBefore);
+	remarks.erase(std::unique(remarks.begin(), remarks.end(), sameRemark), remarks.end());
+
+	ofstream out(path.c_str(), std::ios::out);
+	for (unsigned int i = 0; i < remarks.size(); i++)
+	{
+		const CRemark& r = remarks[i];
+		out << "--- !" << kindNames[r.kind] << "\n";
+		out << "Pass:            " << r.pass << "\n";
+		out << "Name:            " << r.name << "\n";
+		out << "DebugLoc:        { File: ";
+		writeYamlString(out, source);
+		out << ", Line: " << r.line << ", Column: 0 }\n";
+		out << "Function:        ";
+		writeYamlString(out, r.function);
+		out << "\n";
+		out << "Args:\n";
+		out << "  - String:          ";
+		writeYamlString(out, r.message);
+		out << "\n";
+		out << "...\n";
+	}
+	remarks.clear();
+	out.close();
+	return !out.fail();
+}
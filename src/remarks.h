@@ -0,0 +1,87 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REMARKS_H
+#define REMARKS_H
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <pthread.h>
+
+/** Tipo de observacion, como en los registros de optimizacion de LLVM. **/
+enum ERemarkKind
+{
+	//La optimizacion se aplico
+	RK_PASSED,
+	//La optimizacion no se aplico, el mensaje dice por que
+	RK_MISSED,
+	//Informacion sobre el codigo generado
+	RK_ANALYSIS
+};
+
+/**
+ * @class CRemark
+ * @brief Una observacion sobre una linea del fuente.
+ **/
+struct CRemark
+{
+	ERemarkKind kind;
+	const char* pass;
+	const char* name;
+	string function;
+	int line;
+	string message;
+	//Orden de llegada, para desempatar al ordenar
+	long order;
+};
+
+/**
+ * @class CRemarks
+ * @brief Observaciones de las pasadas de optimizacion (--remarks): que se optimizo en cada
+ * linea del fuente, o por que no. Se juntan en memoria desde todos los hilos y al final se
+ * escriben en YAML, ordenadas por linea, con el formato de -fsave-optimization-record.
+ **/
+class CRemarks
+{
+	private:
+		bool enabled;
+		string path;
+		vector<CRemark> remarks;
+		pthread_mutex_t mutex;
+	public:
+		CRemarks();
+		~CRemarks();
+
+		/** Empieza a registrar observaciones, que se escriben en path al invocar write. **/
+		void open(const char* path);
+		bool isEnabled() { return enabled; }
+
+		/** Registra una observacion de pass (nombre de la pasada) sobre la linea line de function. **/
+		void add(ERemarkKind kind, const char* pass, const char* name, const string& function, int line, const string& message);
+
+		/** Escribe el archivo, con source como nombre del fuente. Devuelve false si no se pudo escribir. **/
+		bool write(const char* source);
+};
+
+extern CRemarks remarks;
+
+#endif
@@ -0,0 +1,3082 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 1
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 19 "samp.y"
+
+
+#include <cstring>
+#include <cstdlib>
+#include "ast.h"
+#include "parallel.h"
+#include "stats.h"
+#include "trace.h"
+#include "passes.h"
+#include "remarks.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+RootNode* raiz = new RootNode();
+//Cada hilo que valida funciones tiene su propia bandera
+__thread bool semantics = true;
+//Opciones del compilador. Las pasadas de optimizacion habilitadas estan en passes.
+bool memoStats = false;
+bool licmReport = false;
+int jobs = 0;
+bool dumpTokensOnly = false;
+bool printPasses = false;
+bool stream = false;
+bool filter = false;
+bool unbufferedOutput = false;
+//Tablas de lineas y de variables locales y ruta completa del fuente (sin --strip-debug)
+bool debugInfo = true;
+//Contadores de llamadas y de iteraciones en el codigo generado (--instrument)
+bool instrument = false;
+//Estadisticas de la compilacion (--time-passes y --stats-json)
+bool timePasses = false;
+const char* statsJson = NULL;
+//Traza de las pasadas en formato de Chrome (--trace)
+const char* tracePath = NULL;
+//Observaciones de las pasadas de optimizacion en YAML (--remarks)
+const char* remarksPath = NULL;
+//Archivos a generar (--emit)
+bool emitAst = false;
+bool emitOptAst = false;
+bool emitAsm = false;
+bool emitOptAsm = true;
+const char *filename;
+//Nombre del fuente en .source
+string sourceName = "stdin";
+
+//Los operadores asocian a derecha, por lo que una cadena de N terminos deja N simbolos
+//en la pila del parser hasta reducirla. Esa pila crece en el heap, no en la nativa.
+#define YYMAXDEPTH 50000000
+
+
+#line 123 "samp.tab.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "samp.tab.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_LPAR = 3,                       /* LPAR  */
+  YYSYMBOL_RPAR = 4,                       /* RPAR  */
+  YYSYMBOL_BOOL = 5,                       /* BOOL  */
+  YYSYMBOL_NUM = 6,                        /* NUM  */
+  YYSYMBOL_REAL = 7,                       /* REAL  */
+  YYSYMBOL_INT = 8,                        /* INT  */
+  YYSYMBOL_FLOAT = 9,                      /* FLOAT  */
+  YYSYMBOL_STRING = 10,                    /* STRING  */
+  YYSYMBOL_VOID = 11,                      /* VOID  */
+  YYSYMBOL_TRUE = 12,                      /* TRUE  */
+  YYSYMBOL_FALSE = 13,                     /* FALSE  */
+  YYSYMBOL_NOT = 14,                       /* NOT  */
+  YYSYMBOL_TIMES = 15,                     /* TIMES  */
+  YYSYMBOL_DIVIDEBY = 16,                  /* DIVIDEBY  */
+  YYSYMBOL_PLUS = 17,                      /* PLUS  */
+  YYSYMBOL_MINUS = 18,                     /* MINUS  */
+  YYSYMBOL_ASSIGN = 19,                    /* ASSIGN  */
+  YYSYMBOL_OR = 20,                        /* OR  */
+  YYSYMBOL_AND = 21,                       /* AND  */
+  YYSYMBOL_EQUALS = 22,                    /* EQUALS  */
+  YYSYMBOL_NOTEQUAL = 23,                  /* NOTEQUAL  */
+  YYSYMBOL_LESS = 24,                      /* LESS  */
+  YYSYMBOL_LESSEQ = 25,                    /* LESSEQ  */
+  YYSYMBOL_GREATER = 26,                   /* GREATER  */
+  YYSYMBOL_GREATEREQ = 27,                 /* GREATEREQ  */
+  YYSYMBOL_IF = 28,                        /* IF  */
+  YYSYMBOL_ELSE = 29,                      /* ELSE  */
+  YYSYMBOL_WHILE = 30,                     /* WHILE  */
+  YYSYMBOL_RETURN = 31,                    /* RETURN  */
+  YYSYMBOL_COLON = 32,                     /* COLON  */
+  YYSYMBOL_LCURL = 33,                     /* LCURL  */
+  YYSYMBOL_RCURL = 34,                     /* RCURL  */
+  YYSYMBOL_SEMICOLON = 35,                 /* SEMICOLON  */
+  YYSYMBOL_ID = 36,                        /* ID  */
+  YYSYMBOL_YYACCEPT = 37,                  /* $accept  */
+  YYSYMBOL_prog = 38,                      /* prog  */
+  YYSYMBOL_function = 39,                  /* function  */
+  YYSYMBOL_declaration = 40,               /* declaration  */
+  YYSYMBOL_args = 41,                      /* args  */
+  YYSYMBOL_params = 42,                    /* params  */
+  YYSYMBOL_exp = 43,                       /* exp  */
+  YYSYMBOL_stmtlst = 44,                   /* stmtlst  */
+  YYSYMBOL_stmt = 45,                      /* stmt  */
+  YYSYMBOL_body = 46,                      /* body  */
+  YYSYMBOL_fcall = 47,                     /* fcall  */
+  YYSYMBOL_type = 48                       /* type  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 155 "samp.y"
+
+
+/** Copia el texto de un token al construir el nodo que lo guarda. **/
+static string text(CSlice s)
+{
+	return string(s.text, s.size);
+}
+
+
+#line 216 "samp.tab.cpp"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  10
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   275
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  37
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  12
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  54
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  103
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   291
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   233,   233,   234,   235,   236,   238,   239,   241,   242,
+     244,   249,   254,   255,   258,   259,   260,   261,   262,   263,
+     264,   265,   266,   267,   268,   269,   270,   271,   272,   273,
+     274,   275,   276,   277,   278,   281,   282,   284,   285,   286,
+     287,   288,   289,   290,   291,   292,   294,   295,   297,   298,
+     300,   301,   302,   303,   304
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "LPAR", "RPAR", "BOOL",
+  "NUM", "REAL", "INT", "FLOAT", "STRING", "VOID", "TRUE", "FALSE", "NOT",
+  "TIMES", "DIVIDEBY", "PLUS", "MINUS", "ASSIGN", "OR", "AND", "EQUALS",
+  "NOTEQUAL", "LESS", "LESSEQ", "GREATER", "GREATEREQ", "IF", "ELSE",
+  "WHILE", "RETURN", "COLON", "LCURL", "RCURL", "SEMICOLON", "ID",
+  "$accept", "prog", "function", "declaration", "args", "params", "exp",
+  "stmtlst", "stmt", "body", "fcall", "type", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-73)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+      98,   -73,   -73,   -73,   -73,   -73,     5,    98,    98,    12,
+     -73,   -73,   -73,    23,   121,    74,   -73,   -27,    47,    18,
+      74,   -73,   -73,   -73,   -73,   -73,    74,    44,   162,   -73,
+      84,   -73,   -27,    29,   119,   223,     8,    74,    74,    74,
+      74,    74,    74,    74,    74,    74,    74,    74,    74,   -73,
+      59,    60,    43,   -73,    -2,   -73,    31,    91,   -73,    33,
+      34,   -73,    98,   -73,   -73,    65,   210,   234,   234,   242,
+     242,   248,   248,   -73,   -73,   -73,   -73,   -73,   -73,    74,
+      74,   -73,   178,    74,   -73,   -73,   -73,   -12,   -73,   -73,
+      74,   134,   149,   -73,   194,   -73,    91,    91,   -73,    45,
+     -73,    91,   -73
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,    50,    51,    52,    53,    54,     0,     2,     4,     0,
+       1,     3,     5,     0,     0,     0,     8,     0,     0,     0,
+       0,    14,    15,    33,    21,    22,     0,    32,     0,    34,
+       0,     7,     0,    10,     0,    23,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     9,
+       0,     0,     0,    47,     0,    37,     0,    35,    41,     0,
+       0,     6,     0,    16,    49,     0,    12,    19,    20,    17,
+      18,    26,    27,    24,    25,    28,    29,    30,    31,     0,
+       0,    45,     0,     0,    46,    36,    42,     0,    11,    48,
+       0,     0,     0,    44,     0,    13,     0,     0,    43,    38,
+      40,     0,    39
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -73,    -4,   -73,    52,    13,    -8,    -7,    26,   -72,    11,
+     -30,     2
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     6,     7,    55,    18,    65,    66,    56,    57,    58,
+      29,    60
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int8 yytable[] =
+{
+      59,    36,     9,    11,    12,    10,    30,    15,    28,     9,
+       9,    20,    64,    34,    21,    22,    19,    83,    23,    35,
+      24,    25,    26,    16,    99,   100,    14,    59,    31,   102,
+      67,    68,    69,    70,    71,    72,    73,    74,    75,    76,
+      77,    78,    15,    61,    27,    82,    20,    36,    13,    21,
+      22,    32,     8,    23,    33,    24,    25,    26,    16,     8,
+       8,    62,    79,    80,    19,    84,    59,    59,    86,    89,
+      87,    59,    91,    92,   101,    88,    94,    20,    81,    27,
+      21,    22,    95,    85,    23,     0,    24,    25,    26,     1,
+       0,     0,     2,     3,     4,     5,     1,     0,     0,     2,
+       3,     4,     5,     1,     0,     0,     2,     3,     4,     5,
+      27,     0,    50,     0,    51,    52,     0,    30,    53,    50,
+      54,    51,    52,    63,    30,    17,     1,    54,     0,     2,
+       3,     4,     5,     0,    37,    38,    39,    40,    96,    41,
+      42,    43,    44,    45,    46,    47,    48,     0,     0,    37,
+      38,    39,    40,    97,    41,    42,    43,    44,    45,    46,
+      47,    48,     0,     0,    37,    38,    39,    40,     0,    41,
+      42,    43,    44,    45,    46,    47,    48,    37,    38,    39,
+      40,     0,    41,    42,    43,    44,    45,    46,    47,    48,
+       0,     0,     0,    37,    38,    39,    40,    49,    41,    42,
+      43,    44,    45,    46,    47,    48,     0,     0,     0,    37,
+      38,    39,    40,    93,    41,    42,    43,    44,    45,    46,
+      47,    48,     0,     0,     0,    37,    38,    39,    40,    98,
+      41,    42,    43,    44,    45,    46,    47,    48,    37,    38,
+      39,    40,    90,    41,    42,    43,    44,    45,    46,    47,
+      48,    39,    40,     0,    41,    42,    43,    44,    45,    46,
+      47,    48,    41,    42,    43,    44,    45,    46,    47,    48,
+      43,    44,    45,    46,    47,    48
+};
+
+static const yytype_int8 yycheck[] =
+{
+      30,     3,     0,     7,     8,     0,    33,    19,    15,     7,
+       8,     3,     4,    20,     6,     7,    14,    19,    10,    26,
+      12,    13,    14,    35,    96,    97,     3,    57,    17,   101,
+      37,    38,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    19,    32,    36,    52,     3,     3,    36,     6,
+       7,     4,     0,    10,    36,    12,    13,    14,    35,     7,
+       8,    32,     3,     3,    62,    34,    96,    97,    35,     4,
+      36,   101,    79,    80,    29,    62,    83,     3,    35,    36,
+       6,     7,    90,    57,    10,    -1,    12,    13,    14,     5,
+      -1,    -1,     8,     9,    10,    11,     5,    -1,    -1,     8,
+       9,    10,    11,     5,    -1,    -1,     8,     9,    10,    11,
+      36,    -1,    28,    -1,    30,    31,    -1,    33,    34,    28,
+      36,    30,    31,     4,    33,     4,     5,    36,    -1,     8,
+       9,    10,    11,    -1,    15,    16,    17,    18,     4,    20,
+      21,    22,    23,    24,    25,    26,    27,    -1,    -1,    15,
+      16,    17,    18,     4,    20,    21,    22,    23,    24,    25,
+      26,    27,    -1,    -1,    15,    16,    17,    18,    -1,    20,
+      21,    22,    23,    24,    25,    26,    27,    15,    16,    17,
+      18,    -1,    20,    21,    22,    23,    24,    25,    26,    27,
+      -1,    -1,    -1,    15,    16,    17,    18,    35,    20,    21,
+      22,    23,    24,    25,    26,    27,    -1,    -1,    -1,    15,
+      16,    17,    18,    35,    20,    21,    22,    23,    24,    25,
+      26,    27,    -1,    -1,    -1,    15,    16,    17,    18,    35,
+      20,    21,    22,    23,    24,    25,    26,    27,    15,    16,
+      17,    18,    32,    20,    21,    22,    23,    24,    25,    26,
+      27,    17,    18,    -1,    20,    21,    22,    23,    24,    25,
+      26,    27,    20,    21,    22,    23,    24,    25,    26,    27,
+      22,    23,    24,    25,    26,    27
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     5,     8,     9,    10,    11,    38,    39,    40,    48,
+       0,    38,    38,    36,     3,    19,    35,     4,    41,    48,
+       3,     6,     7,    10,    12,    13,    14,    36,    43,    47,
+      33,    46,     4,    36,    43,    43,     3,    15,    16,    17,
+      18,    20,    21,    22,    23,    24,    25,    26,    27,    35,
+      28,    30,    31,    34,    36,    40,    44,    45,    46,    47,
+      48,    46,    32,     4,     4,    42,    43,    43,    43,    43,
+      43,    43,    43,    43,    43,    43,    43,    43,    43,     3,
+       3,    35,    43,    19,    34,    44,    35,    36,    41,     4,
+      32,    43,    43,    35,    43,    42,     4,     4,    35,    45,
+      45,    29,    45
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    37,    38,    38,    38,    38,    39,    39,    40,    40,
+      41,    41,    42,    42,    43,    43,    43,    43,    43,    43,
+      43,    43,    43,    43,    43,    43,    43,    43,    43,    43,
+      43,    43,    43,    43,    43,    44,    44,    45,    45,    45,
+      45,    45,    45,    45,    45,    45,    46,    46,    47,    47,
+      48,    48,    48,    48,    48
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     1,     2,     6,     5,     3,     5,
+       2,     4,     1,     3,     1,     1,     3,     3,     3,     3,
+       3,     1,     1,     2,     3,     3,     3,     3,     3,     3,
+       3,     3,     1,     1,     1,     0,     2,     1,     5,     7,
+       5,     1,     2,     4,     3,     2,     3,     2,     4,     3,
+       1,     1,     1,     1,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, scanner, chunk, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+#ifndef YYLLOC_DEFAULT
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+{
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
+  return res;
+}
+
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, Location, scanner, chunk); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, CParseChunk* chunk)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (chunk);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, CParseChunk* chunk)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, scanner, chunk);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, yyscan_t scanner, CParseChunk* chunk)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), scanner, chunk);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, scanner, chunk); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, yyscan_t scanner, CParseChunk* chunk)
+{
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (chunk);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (yyscan_t scanner, CParseChunk* chunk)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+/* Location data for the lookahead symbol.  */
+static YYLTYPE yyloc_default
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+YYLTYPE yylloc = yyloc_default;
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+  YYLTYPE yyloc;
+
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  yylsp[0] = yylloc;
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+        YYLTYPE *yyls1 = yyls;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+        yyls = yyls1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, &yylloc, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+  *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+  /* Default location. */
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* prog: function  */
+#line 233 "samp.y"
+                                                        { chunk->root->append((yyvsp[0].funcDecl)); }
+#line 1394 "samp.tab.cpp"
+    break;
+
+  case 3: /* prog: function prog  */
+#line 234 "samp.y"
+                                                        { chunk->root->append((yyvsp[-1].funcDecl)); }
+#line 1400 "samp.tab.cpp"
+    break;
+
+  case 4: /* prog: declaration  */
+#line 235 "samp.y"
+                                                        { chunk->root->append((yyvsp[0].varDecl)); }
+#line 1406 "samp.tab.cpp"
+    break;
+
+  case 5: /* prog: declaration prog  */
+#line 236 "samp.y"
+                                                                { chunk->root->append((yyvsp[-1].varDecl)); }
+#line 1412 "samp.tab.cpp"
+    break;
+
+  case 6: /* function: type ID LPAR args RPAR body  */
+#line 238 "samp.y"
+                                                        { (yyval.funcDecl) = new FuncDeclNode((yyvsp[-5].tipo),new IDNode(text((yyvsp[-4].slice))),(yyvsp[-2].funcDeclArgs),(yyvsp[0].bodyNode)); }
+#line 1418 "samp.tab.cpp"
+    break;
+
+  case 7: /* function: type ID LPAR RPAR body  */
+#line 239 "samp.y"
+                                                        { (yyval.funcDecl) = new FuncDeclNode((yyvsp[-4].tipo),new IDNode(text((yyvsp[-3].slice))),NULL,(yyvsp[0].bodyNode)); }
+#line 1424 "samp.tab.cpp"
+    break;
+
+  case 8: /* declaration: type ID SEMICOLON  */
+#line 241 "samp.y"
+                                                        { (yyval.varDecl) = new DeclNode((yyvsp[-2].tipo),new IDNode(text((yyvsp[-1].slice))),NULL); }
+#line 1430 "samp.tab.cpp"
+    break;
+
+  case 9: /* declaration: type ID ASSIGN exp SEMICOLON  */
+#line 242 "samp.y"
+                                                        { (yyval.varDecl) = new DeclNode((yyvsp[-4].tipo),new IDNode(text((yyvsp[-3].slice))),(yyvsp[-1].expr)); }
+#line 1436 "samp.tab.cpp"
+    break;
+
+  case 10: /* args: type ID  */
+#line 244 "samp.y"
+                                                        {  list< pair<Tipo,IDNode*> >* l = new list< pair<Tipo,IDNode*> >();
+							   pair<Tipo,IDNode*> p; p.first = (yyvsp[-1].tipo); p.second = new IDNode(text((yyvsp[0].slice)));
+							   l->push_front(p);
+							   (yyval.funcDeclArgs) = new ArgsNode(l);
+							}
+#line 1446 "samp.tab.cpp"
+    break;
+
+  case 11: /* args: type ID COLON args  */
+#line 249 "samp.y"
+                                                        {  pair<Tipo, IDNode*> p; p.first = (yyvsp[-3].tipo); p.second = new IDNode(text((yyvsp[-2].slice)));
+							   (yyvsp[0].funcDeclArgs)->getList()->push_front(p);
+							   (yyval.funcDeclArgs) = (yyvsp[0].funcDeclArgs);
+							}
+#line 1455 "samp.tab.cpp"
+    break;
+
+  case 12: /* params: exp  */
+#line 254 "samp.y"
+                                                        { list<Exp*>* l = new list<Exp*>(); l->push_front((yyvsp[0].expr)); (yyval.lparams) = l;}
+#line 1461 "samp.tab.cpp"
+    break;
+
+  case 13: /* params: exp COLON params  */
+#line 255 "samp.y"
+                                                        { (yyvsp[0].lparams)->push_front((yyvsp[-2].expr)); (yyval.lparams) = (yyvsp[0].lparams); }
+#line 1467 "samp.tab.cpp"
+    break;
+
+  case 14: /* exp: NUM  */
+#line 258 "samp.y"
+                                                        { (yyval.expr) = new IntConst((yyvsp[0].ival)); }
+#line 1473 "samp.tab.cpp"
+    break;
+
+  case 15: /* exp: REAL  */
+#line 259 "samp.y"
+                                                        { (yyval.expr) = new FloatConst((yyvsp[0].fval)); }
+#line 1479 "samp.tab.cpp"
+    break;
+
+  case 16: /* exp: LPAR exp RPAR  */
+#line 260 "samp.y"
+                                                        { (yyval.expr) = new UnExp(OP_PAR, (yyvsp[-1].expr)); }
+#line 1485 "samp.tab.cpp"
+    break;
+
+  case 17: /* exp: exp PLUS exp  */
+#line 261 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_PLUS, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1491 "samp.tab.cpp"
+    break;
+
+  case 18: /* exp: exp MINUS exp  */
+#line 262 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_MINUS, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1497 "samp.tab.cpp"
+    break;
+
+  case 19: /* exp: exp TIMES exp  */
+#line 263 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_TIMES, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1503 "samp.tab.cpp"
+    break;
+
+  case 20: /* exp: exp DIVIDEBY exp  */
+#line 264 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_DIVIDEBY, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1509 "samp.tab.cpp"
+    break;
+
+  case 21: /* exp: TRUE  */
+#line 265 "samp.y"
+                                                        { (yyval.expr) = new BoolConst((yyvsp[0].bval)); }
+#line 1515 "samp.tab.cpp"
+    break;
+
+  case 22: /* exp: FALSE  */
+#line 266 "samp.y"
+                                                        { (yyval.expr) = new BoolConst((yyvsp[0].bval)); }
+#line 1521 "samp.tab.cpp"
+    break;
+
+  case 23: /* exp: NOT exp  */
+#line 267 "samp.y"
+                                                { (yyval.expr) = new UnExp(OP_NOT, (yyvsp[0].expr)); }
+#line 1527 "samp.tab.cpp"
+    break;
+
+  case 24: /* exp: exp EQUALS exp  */
+#line 268 "samp.y"
+                                                { (yyval.expr) = new BinExp(OP_EQUALS, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1533 "samp.tab.cpp"
+    break;
+
+  case 25: /* exp: exp NOTEQUAL exp  */
+#line 269 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_NOTEQUAL, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1539 "samp.tab.cpp"
+    break;
+
+  case 26: /* exp: exp OR exp  */
+#line 270 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_OR, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1545 "samp.tab.cpp"
+    break;
+
+  case 27: /* exp: exp AND exp  */
+#line 271 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_AND, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1551 "samp.tab.cpp"
+    break;
+
+  case 28: /* exp: exp LESS exp  */
+#line 272 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_LESS, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1557 "samp.tab.cpp"
+    break;
+
+  case 29: /* exp: exp LESSEQ exp  */
+#line 273 "samp.y"
+                                                { (yyval.expr) = new BinExp(OP_LESSEQ, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1563 "samp.tab.cpp"
+    break;
+
+  case 30: /* exp: exp GREATER exp  */
+#line 274 "samp.y"
+                                                { (yyval.expr) = new BinExp(OP_GREATER, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1569 "samp.tab.cpp"
+    break;
+
+  case 31: /* exp: exp GREATEREQ exp  */
+#line 275 "samp.y"
+                                                        { (yyval.expr) = new BinExp(OP_GREATEREQ, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 1575 "samp.tab.cpp"
+    break;
+
+  case 32: /* exp: ID  */
+#line 276 "samp.y"
+                                                        { (yyval.expr) = new IDNode(text((yyvsp[0].slice))); }
+#line 1581 "samp.tab.cpp"
+    break;
+
+  case 33: /* exp: STRING  */
+#line 277 "samp.y"
+                                                        { (yyval.expr) = new StringConst(text((yyvsp[0].slice))); }
+#line 1587 "samp.tab.cpp"
+    break;
+
+  case 34: /* exp: fcall  */
+#line 278 "samp.y"
+                                                        { FCallNode* fcalln = (yyvsp[0].fcallNode); fcalln->setStmt(false); (yyval.expr) = (yyvsp[0].fcallNode); }
+#line 1593 "samp.tab.cpp"
+    break;
+
+  case 35: /* stmtlst: %empty  */
+#line 281 "samp.y"
+                                                        { (yyval.lstmt) = new list< Statement* >(); }
+#line 1599 "samp.tab.cpp"
+    break;
+
+  case 36: /* stmtlst: stmt stmtlst  */
+#line 282 "samp.y"
+                                                        { (yyvsp[0].lstmt)->push_front((yyvsp[-1].statement)); (yyval.lstmt) = (yyvsp[0].lstmt); }
+#line 1605 "samp.tab.cpp"
+    break;
+
+  case 37: /* stmt: declaration  */
+#line 284 "samp.y"
+                                                        { (yyval.statement) = (yyvsp[0].varDecl); }
+#line 1611 "samp.tab.cpp"
+    break;
+
+  case 38: /* stmt: IF LPAR exp RPAR stmt  */
+#line 285 "samp.y"
+                                                        { (yyval.statement) = new StmtIf((yyvsp[-2].expr),(yyvsp[0].statement), NULL); }
+#line 1617 "samp.tab.cpp"
+    break;
+
+  case 39: /* stmt: IF LPAR exp RPAR stmt ELSE stmt  */
+#line 286 "samp.y"
+                                                { (yyval.statement) = new StmtIf((yyvsp[-4].expr),(yyvsp[-2].statement),(yyvsp[0].statement)); }
+#line 1623 "samp.tab.cpp"
+    break;
+
+  case 40: /* stmt: WHILE LPAR exp RPAR stmt  */
+#line 287 "samp.y"
+                                                        { (yyval.statement) = new StmtWhile((yyvsp[-2].expr),(yyvsp[0].statement)); }
+#line 1629 "samp.tab.cpp"
+    break;
+
+  case 41: /* stmt: body  */
+#line 288 "samp.y"
+                                                        { (yyval.statement) = (yyvsp[0].bodyNode); }
+#line 1635 "samp.tab.cpp"
+    break;
+
+  case 42: /* stmt: fcall SEMICOLON  */
+#line 289 "samp.y"
+                                                { (yyval.statement) = (yyvsp[-1].fcallNode); }
+#line 1641 "samp.tab.cpp"
+    break;
+
+  case 43: /* stmt: ID ASSIGN exp SEMICOLON  */
+#line 290 "samp.y"
+                                                { (yyval.statement) = new AssignNode(new IDNode(text((yyvsp[-3].slice))),(yyvsp[-1].expr)); }
+#line 1647 "samp.tab.cpp"
+    break;
+
+  case 44: /* stmt: RETURN exp SEMICOLON  */
+#line 291 "samp.y"
+                                                { (yyval.statement) = new StmtReturn((yyvsp[-1].expr)); }
+#line 1653 "samp.tab.cpp"
+    break;
+
+  case 45: /* stmt: RETURN SEMICOLON  */
+#line 292 "samp.y"
+                                                        { (yyval.statement) = new StmtReturn(NULL); }
+#line 1659 "samp.tab.cpp"
+    break;
+
+  case 46: /* body: LCURL stmtlst RCURL  */
+#line 294 "samp.y"
+                                                        { (yyval.bodyNode) = new BodyNode((yyvsp[-1].lstmt)); }
+#line 1665 "samp.tab.cpp"
+    break;
+
+  case 47: /* body: LCURL RCURL  */
+#line 295 "samp.y"
+                                                        { (yyval.bodyNode) = new BodyNode(NULL); }
+#line 1671 "samp.tab.cpp"
+    break;
+
+  case 48: /* fcall: ID LPAR params RPAR  */
+#line 297 "samp.y"
+                                                        { (yyval.fcallNode) = new FCallNode(new IDNode(text((yyvsp[-3].slice))),(yyvsp[-1].lparams)); }
+#line 1677 "samp.tab.cpp"
+    break;
+
+  case 49: /* fcall: ID LPAR RPAR  */
+#line 298 "samp.y"
+                                                        { (yyval.fcallNode) = new FCallNode(new IDNode(text((yyvsp[-2].slice))),NULL); }
+#line 1683 "samp.tab.cpp"
+    break;
+
+  case 50: /* type: BOOL  */
+#line 300 "samp.y"
+                                                        { (yyval.tipo) = TBOOL; }
+#line 1689 "samp.tab.cpp"
+    break;
+
+  case 51: /* type: INT  */
+#line 301 "samp.y"
+                                                        { (yyval.tipo) = TINT; }
+#line 1695 "samp.tab.cpp"
+    break;
+
+  case 52: /* type: FLOAT  */
+#line 302 "samp.y"
+                                                        { (yyval.tipo) = TFLOAT; }
+#line 1701 "samp.tab.cpp"
+    break;
+
+  case 53: /* type: STRING  */
+#line 303 "samp.y"
+                                                        { (yyval.tipo) = TSTRING; }
+#line 1707 "samp.tab.cpp"
+    break;
+
+  case 54: /* type: VOID  */
+#line 304 "samp.y"
+                                                        { (yyval.tipo) = TVOID; }
+#line 1713 "samp.tab.cpp"
+    break;
+
+
+#line 1717 "samp.tab.cpp"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+  *++yylsp = yyloc;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (&yylloc, scanner, chunk, YY_("syntax error"));
+    }
+
+  yyerror_range[1] = yylloc;
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, &yylloc, scanner, chunk);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+      yyerror_range[1] = *yylsp;
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, scanner, chunk);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (&yylloc, scanner, chunk, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, &yylloc, scanner, chunk);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, scanner, chunk);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 306 "samp.y"
+
+bool isSubStr(const string& str, const char* subStr);
+string subStrFromCh(const string& str, char ch);
+
+int yyerror(YYLTYPE*, yyscan_t, CParseChunk* chunk, const char*)
+{
+	ostringstream msg;
+	msg << "Grammar error: line[" << line << "]\n";
+	chunk->messages += msg.str();
+	return 0;
+}
+
+//Tamano minimo de cada parte del fuente que se analiza en paralelo
+const int minChunkSize = 16384;
+
+/**
+ * @class CSplitState
+ * @brief Estado de la busqueda de los fines de declaracion en el fuente (ver nextDeclarationEnd).
+ **/
+struct CSplitState
+{
+	//Proximo caracter a revisar y bloques abiertos
+	int pos;
+	int depth;
+	//Linea actual y posicion del ultimo salto de linea contado, para las columnas
+	int line;
+	int newline;
+	//Se cerro una llave de mas: ya no se puede cortar en ningun lado
+	bool unbalanced;
+};
+
+/**
+ * Busca donde termina la proxima declaracion global o funcion: en un ';' o una '}' fuera de
+ * todo bloque. Se saltean las cadenas y los comentarios, y las lineas y columnas se cuentan
+ * como en el scanner: los saltos de linea dentro de una cadena no cuentan. Devuelve la
+ * posicion siguiente al fin, o -1 si no hay mas. Si more es true, falta leer parte del fuente:
+ * se detiene antes de una cadena o un comentario que puede terminar en lo que falta.
+ **/
+static int nextDeclarationEnd(const char* source, int size, bool more, CSplitState& state)
+{
+	while (!state.unbalanced && state.pos < size)
+	{
+		int i = state.pos;
+		char c = source[i];
+		if (c == '\n')
+		{
+			state.line++;
+			state.newline = i;
+		}
+		else if (c == '"')
+		{
+			//Una comilla sin cerrar no es una cadena para el scanner
+			const char* close = (const char*)memchr(source + i + 1, '"', size - i - 1);
+			if (close != NULL)
+			{
+				i = close - source;
+			}
+			else if (more)
+			{
+				return -1;
+			}
+		}
+		else if (c == '/' && (i + 1 < size || more))
+		{
+			if (i + 1 == size)
+			{
+				return -1;
+			}
+			if (source[i + 1] == '/')
+			{
+				//El salto de linea que termina el comentario se cuenta en la siguiente vuelta
+				const char* eol = (const char*)memchr(source + i, '\n', size - i);
+				if (eol == NULL && more)
+				{
+					return -1;
+				}
+				i = (eol == NULL) ? size - 1 : eol - source - 1;
+			}
+		}
+		else if (c == '{')
+		{
+			state.depth++;
+		}
+		else if (c == '}' || c == ';')
+		{
+			if (c == '}' && --state.depth < 0)
+			{
+				//Llaves desbalanceadas: el resto va junto y el parser dara el error
+				state.unbalanced = true;
+				return -1;
+			}
+			if (state.depth == 0)
+			{
+				state.pos = i + 1;
+				return i + 1;
+			}
+		}
+		state.pos = i + 1;
+	}
+	return -1;
+}
+
+/** Divide el fuente en partes que terminan donde termina una declaracion global o una funcion. **/
+static void splitSource(const char* source, int size, vector<CParseChunk>& chunks)
+{
+	int parts = getThreadCount();
+	if (parts > size / minChunkSize)
+	{
+		parts = size / minChunkSize;
+	}
+
+	//Fin de cada declaracion, y linea y ultimo salto de linea antes de lo que sigue
+	vector<int> ends;
+	vector<int> lines;
+	vector<int> newlines;
+	CSplitState state = {0, 0, 1, -1, false};
+	int end;
+	while (parts > 1 && (end = nextDeclarationEnd(source, size, false, state)) >= 0)
+	{
+		ends.push_back(end);
+		lines.push_back(state.line);
+		newlines.push_back(state.newline);
+	}
+
+	//Se corta en la declaracion que termina mas cerca de cada fraccion del fuente. Lo que
+	//sigue a la ultima declaracion queda con ella, asi ninguna parte queda sin declaraciones.
+	int start = 0;
+	int startLine = 1;
+	int startColumn = 1;
+	unsigned int e = 0;
+	unsigned int cuts = ends.empty() ? 0 : ends.size() - 1;
+	for (int p = 1; p < parts; p++)
+	{
+		int target = (int)(size * (double)p / parts);
+		while (e < cuts && ends[e] < target)
+		{
+			e++;
+		}
+		if (e == cuts)
+		{
+			break;
+		}
+		CParseChunk chunk;
+		chunk.text = source + start;
+		chunk.size = ends[e] - start;
+		chunk.firstLine = startLine;
+		chunk.firstColumn = startColumn;
+		chunks.push_back(chunk);
+		start = ends[e];
+		startLine = lines[e];
+		startColumn = start - newlines[e];
+		e++;
+	}
+	CParseChunk last;
+	last.text = source + start;
+	last.size = size - start;
+	last.firstLine = startLine;
+	last.firstColumn = startColumn;
+	chunks.push_back(last);
+
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		chunks[i].root = new RootNode();
+		chunks[i].result = 0;
+	}
+}
+
+//Tamano de cada lectura del fuente al compilar a medida que se lee (--stream)
+const int streamBlockSize = 65536;
+
+/** Analiza una parte del fuente y pasa sus declaraciones, en orden, al compilador. **/
+static int parseDeclarations(const char* text, int size, int firstLine, int firstColumn, CStreamCompiler& compiler)
+{
+	CParseChunk chunk;
+	chunk.text = text;
+	chunk.size = size;
+	chunk.firstLine = firstLine;
+	chunk.firstColumn = firstColumn;
+	chunk.root = new RootNode();
+	chunk.result = parseChunk(&chunk);
+	cout << chunk.messages;
+	if (chunk.result == 0)
+	{
+		Node* node;
+		while ((node = chunk.root->takeFirst()) != NULL)
+		{
+			compiler.add(node);
+		}
+	}
+	delete chunk.root;
+	return chunk.result;
+}
+
+/**
+ * Lee el fuente de a bloques y analiza cada declaracion apenas termina de leerla. Cada una
+ * se analiza al encontrar el fin de la siguiente, asi lo que sigue a la ultima queda con ella.
+ * En memoria solo quedan las declaraciones que faltan analizar. Como el parser de todo el
+ * fuente, se detiene en el primer error.
+ **/
+static int parseStream(FILE* in, CStreamCompiler& compiler)
+{
+	//Texto leido y no analizado: empieza en start, y la declaracion retenida termina en held
+	string pending;
+	int start = 0;
+	int held = -1;
+	int heldLine = 1;
+	int heldNewline = -1;
+	int firstLine = 1;
+	int firstColumn = 1;
+	CSplitState state = {0, 0, 1, -1, false};
+	vector<char> buffer(streamBlockSize);
+	bool more = true;
+	while (true)
+	{
+		int end = nextDeclarationEnd(pending.data(), pending.size(), more, state);
+		if (end < 0)
+		{
+			if (!more)
+			{
+				break;
+			}
+			//Se descarta lo ya analizado antes de leer mas, si es al menos la mitad del texto
+			if (start > 0 && start >= (int)pending.size() / 2)
+			{
+				pending.erase(0, start);
+				state.pos -= start;
+				state.newline -= start;
+				held -= (held >= 0) ? start : 0;
+				heldNewline -= start;
+				start = 0;
+			}
+			size_t n = fread(&buffer[0], 1, buffer.size(), in);
+			pending.append(&buffer[0], n);
+			more = (n > 0);
+			continue;
+		}
+		if (held >= 0)
+		{
+			int result = parseDeclarations(pending.data() + start, held - start, firstLine, firstColumn, compiler);
+			if (result != 0)
+			{
+				return result;
+			}
+			start = held;
+			firstLine = heldLine;
+			firstColumn = held - heldNewline;
+		}
+		held = end;
+		heldLine = state.line;
+		heldNewline = state.newline;
+	}
+	return parseDeclarations(pending.data() + start, pending.size() - start, firstLine, firstColumn, compiler);
+}
+
+int parseChunk(CParseChunk* chunk)
+{
+	yyscan_t scanner = openScanner(chunk);
+	if (scanner == NULL)
+	{
+		return -1;
+	}
+	int result = yyparse(scanner, chunk);
+	closeScanner(scanner);
+	return result;
+}
+
+/** Nombre de un token en la gramatica. **/
+static const char* tokenName(int token)
+{
+	return yytname[YYTRANSLATE(token)];
+}
+
+void dumpTokens(CParseChunk* chunk, ostream& out)
+{
+	yyscan_t scanner = openScanner(chunk);
+	if (scanner == NULL)
+	{
+		return;
+	}
+	YYSTYPE value;
+	YYLTYPE location;
+	value.slice.text = NULL;
+	int token;
+	while ((token = yylex(&value, &location, scanner)) != 0)
+	{
+		//Los caracteres no reconocidos antes del token
+		out << chunk->messages;
+		chunk->messages.clear();
+
+		out << location.first_line << ":" << location.first_column << " " << tokenName(token);
+		switch (token)
+		{
+			case ID:
+			case STRING:
+				//STRING es tambien el tipo: solo la cadena tiene texto
+				if (value.slice.text != NULL)
+				{
+					out << " " << text(value.slice);
+				}
+				break;
+			case NUM:
+				out << " " << value.ival;
+				break;
+			case REAL:
+				out << " " << value.fval;
+				break;
+			case TRUE:
+			case FALSE:
+				out << " " << value.bval;
+				break;
+		}
+		out << "\n";
+		value.slice.text = NULL;
+	}
+	out << chunk->messages;
+	chunk->messages.clear();
+	closeScanner(scanner);
+}
+
+/**
+ * @class CPeephole
+ * @brief Optimizacion a nivel de codigo objeto sobre cada par de lineas del codigo jasmin:
+ * un store seguido de un load de la misma variable pasa a ser un dup y el store. Las lineas
+ * de depuracion (.line, .var y las etiquetas Scope de las variables) no separan el par, ya
+ * que no generan codigo ni son destino de saltos. Sin la pasada peephole (-O0 o
+ * -fno-peephole) copia las lineas tal cual.
+ **/
+class CPeephole
+{
+	private:
+		ostream& out;
+		//Se reusan para todas las lineas
+		string oldLine;
+		string newLine;
+		//Lineas de depuracion que siguen a oldLine
+		string debugLines;
+		bool first;
+		bool active;
+
+		/** Indica si la linea es de depuracion: .line, .var o una etiqueta Scope. **/
+		static bool isDebugLine(const char* text, int size)
+		{
+			return (size > 6 && strncmp(text, ".line ", 6) == 0) || (size > 5 && strncmp(text, ".var ", 5) == 0) ||
+				(size > 5 && strncmp(text, "Scope", 5) == 0);
+		}
+	public:
+		CPeephole(ostream& o) : out(o), first(true), active(passes.isEnabled(PASS_PEEPHOLE)) {}
+
+		/** Recibe la proxima linea y escribe la anterior, ya optimizada. **/
+		void add(const char* text, int size)
+		{
+			if (!active)
+			{
+				out.write(text, size);
+				out.put('\n');
+				return;
+			}
+			if (!first && isDebugLine(text, size))
+			{
+				debugLines.append(text, size);
+				debugLines += '\n';
+				return;
+			}
+			if (first)
+			{
+				oldLine.assign(text, size);
+				first = false;
+				return;
+			}
+
+			newLine.assign(text, size);
+			if ( (oldLine.size() > 0) && (newLine.size() > 0) && isSubStr(oldLine, "store") && isSubStr(newLine, "load") )
+			{
+				//Compara el segundo caracter (el 1ero es el tipo...), de las dos lineas para ver si coinciden.
+				if (oldLine[1] == newLine[1])
+				{
+					string idAssemStore = subStrFromCh(oldLine, ' ');
+					string idAssemLoad = subStrFromCh(newLine, '_');
+
+					//Verifica que el store y el load sean sobre la misma variable
+					if (idAssemStore == idAssemLoad)
+					{
+						out << "\tdup\n";
+						newLine = "\t;Store optimizado por PeepHole";
+					}
+				}
+			}
+
+			out.write(oldLine.data(), oldLine.size());
+			out.put('\n');
+			out << debugLines;
+			debugLines.clear();
+			oldLine.swap(newLine);
+		}
+
+		/** Escribe la ultima linea. **/
+		void finish()
+		{
+			if (!active)
+			{
+				out.flush();
+				return;
+			}
+			out << oldLine << "\n" << debugLines;
+			out.flush();
+		}
+};
+
+/**
+ * @class CCodeOutput
+ * @brief Ultimas etapas del codigo jasmin, encadenadas en memoria: lo que se escribe en este
+ * buffer se guarda tal cual en comp.j (--emit=asm) y pasa por la optimizacion peephole hacia
+ * compopt.j (--emit=opt-asm), o hacia la salida estandar con --filter. Las lineas completas se
+ * procesan cada vez que se llena el bloque.
+ **/
+class CCodeOutput : public streambuf
+{
+	private:
+		CEmitter asmFile;
+		CEmitter optFile;
+		CPeephole* peephole;
+		vector<char> buffer;
+
+		/** Procesa las lineas completas, la ultima que no lo esta queda al principio del bloque. **/
+		void process(bool last)
+		{
+			EPhase phase = compileStats.enter(PH_PEEPHOLE);
+			char* begin = pbase();
+			char* end = pptr();
+			char* lineStart = begin;
+			char* lineEnd;
+			while ((lineEnd = (char*)memchr(lineStart, '\n', end - lineStart)) != NULL)
+			{
+				if (peephole != NULL)
+				{
+					peephole->add(lineStart, lineEnd - lineStart);
+				}
+				lineStart = lineEnd + 1;
+			}
+			if (emitAsm)
+			{
+				asmFile.write(begin, lineStart - begin);
+			}
+			if (last && lineStart < end)
+			{
+				if (peephole != NULL)
+				{
+					peephole->add(lineStart, end - lineStart);
+				}
+				if (emitAsm)
+				{
+					asmFile.write(lineStart, end - lineStart);
+					asmFile.put('\n');
+				}
+				lineStart = end;
+			}
+
+			//Una linea que ocupa todo el bloque no se puede procesar todavia, se agranda el bloque
+			int rest = end - lineStart;
+			memmove(&buffer[0], lineStart, rest);
+			if (rest == (int)buffer.size())
+			{
+				buffer.resize(buffer.size() * 2);
+			}
+			setp(&buffer[0], &buffer[0] + buffer.size());
+			pbump(rest);
+			compileStats.enter(phase);
+		}
+	protected:
+		int overflow(int c)
+		{
+			process(false);
+			if (c != EOF)
+			{
+				*pptr() = c;
+				pbump(1);
+			}
+			return 0;
+		}
+	public:
+		CCodeOutput() : peephole(NULL), buffer(emitBufferSize)
+		{
+			setp(&buffer[0], &buffer[0] + buffer.size());
+			if (emitAsm)
+			{
+				cout << "Saving object code as \"comp.j\"" << endl;
+				asmFile.open("comp.j");
+			}
+			if (filter)
+			{
+				optFile.attach(1);
+				peephole = new CPeephole(optFile);
+			}
+			else if (emitOptAsm)
+			{
+				cout << "Optimizing object code. Saving as \"compopt.j\"" << endl;
+				optFile.open("compopt.j");
+				peephole = new CPeephole(optFile);
+			}
+		}
+
+		~CCodeOutput()
+		{
+			EPhase phase = compileStats.enter(PH_PEEPHOLE);
+			process(true);
+			if (peephole != NULL)
+			{
+				peephole->finish();
+				delete peephole;
+			}
+			asmFile.close();
+			optFile.close();
+			compileStats.enter(phase);
+		}
+};
+
+/** Registra las funciones predefinidas del lenguaje. **/
+static void addBuiltins(CFunctionTable& functable)
+{
+	list<Tipo> args;
+	args.push_back(TSTRING);
+	functable.addFunction(TVOID, "print", args);
+
+	//print tambien tiene versiones para cada tipo primitivo en lpstdlib.j
+	args.clear();
+	args.push_back(TINT);
+	functable.addOverload(TVOID, "print", args);
+
+	args.clear();
+	args.push_back(TFLOAT);
+	functable.addOverload(TVOID, "print", args);
+
+	args.clear();
+	args.push_back(TBOOL);
+	functable.addOverload(TVOID, "print", args);
+
+	args.clear();
+	args.push_back(TFLOAT);
+	functable.addFunction(TINT, "trunc", args);
+
+	args.clear();
+	args.push_back(TFLOAT);
+	functable.addFunction(TSTRING, "toString", args);
+
+	args.clear();
+	args.push_back(TSTRING);
+	functable.addFunction(TINT, "toInt", args);
+
+	args.clear();
+	functable.addFunction(TSTRING, "read", args);
+
+	//Lectura directa del buffer de stdin, sin pasar por un string
+	args.clear();
+	functable.addFunction(TINT, "readInt", args);
+
+	args.clear();
+	functable.addFunction(TFLOAT, "readFloat", args);
+
+	args.clear();
+	functable.addFunction(TSTRING, "readAll", args);
+}
+
+/**
+ * Compila lo que va antes del codigo de usuario: el cabezal de la clase, las variables
+ * globales, los campos auxiliares de las funciones y la biblioteca estandar.
+ **/
+/**
+ * Nombre del fuente para .source: la ruta completa, para que los perfiladores y depuradores
+ * encuentren el archivo, o tal cual se recibio con --strip-debug o si no se puede resolver.
+ **/
+static string sourcePath(const char* file)
+{
+	string path = file;
+	if (debugInfo)
+	{
+#ifndef _WIN32
+		char* full = realpath(file, NULL);
+#else
+		char* full = _fullpath(NULL, file, 0);
+#endif
+		if (full != NULL)
+		{
+			path = full;
+			free(full);
+		}
+	}
+	//jasmin separa las palabras por espacios
+	if (path.find_first_of(" \t") != string::npos)
+	{
+		path = "\"" + path + "\"";
+	}
+	return path;
+}
+
+static void compileHeader(ostream& comp, CPilaDeSimbolos& stack)
+{
+	//Crear cabezal de clase estatica generada
+	comp << ".source " << sourceName << "\n";
+	comp << ".class " << className << "\n";
+	comp << ".super java/lang/Object\n\n";
+
+	//Compilar las variables globales. Las que nunca se asignan conservan su valor inicial
+	//y se declaran final, para que la JVM pueda tratarlas como constantes.
+	for (list< CNodoPila >::iterator it = stack.getLista().begin(); it != stack.getLista().end(); it++)
+	{
+		Tipo t = it->GetTipoDato();
+		if (!it->EsAsignada() && t != TSTRING)
+		{
+			comp << ".field public static final "<< it->GetID() << " " <<  util::compile(util::Tipo2ExpType(t)) << " = " << (t == TFLOAT ? "0.0" : "0") << "\n";
+		}
+		else
+		{
+			comp << ".field public static "<< it->GetID() << " " <<  util::compile(util::Tipo2ExpType(t)) << "\n";
+		}
+	}
+
+	//Compilar los campos auxiliares de las funciones (caches de memoizacion)
+	raiz->compileFields(comp);
+
+	//Copiar biblioteca Estandar
+	EPhase phase = compileStats.enter(PH_STDLIB);
+	ifstream in("lpstdlib.j");
+	if (!in)
+	{
+		cout << "Error: standar library (lpstdlib.j) missing.\nAborting..." << endl;
+		abort();
+	}
+
+	if (in.peek() != EOF)
+	{
+		comp << in.rdbuf();
+	}
+	comp << "\n";
+	compileStats.enter(phase);
+
+	comp << ";\n; Codigo de usuario\n;\n";
+}
+
+//Archivo donde se compilan los metodos con --stream, hasta conocer los campos que van antes
+const char* streamMethods = "comp.j.tmp";
+
+/**
+ * Compila cada declaracion apenas se lee (--stream), en lugar de analizar todo el fuente
+ * antes de compilarlo. La memoria usada depende de la funcion mas grande y no del fuente.
+ **/
+static int compileStream(FILE* in)
+{
+	cout << "Streaming mode: each declaration is compiled as soon as it is parsed." << endl;
+	CPilaDeSimbolos stack;
+	CFunctionTable functable;
+	addBuiltins(functable);
+
+	//Como con licm.txt, lo que no se pidio con --emit va a un ofstream sin abrir
+	ofstream out;
+	ofstream outopt;
+	if (emitAst)
+	{
+		out.open("out.txt", std::ios::out);
+	}
+	if (emitOptAst)
+	{
+		outopt.open("opt.txt", std::ios::out);
+	}
+	CEmitter methods;
+	methods.open(streamMethods);
+	//Sin --licm-report el reporte se descarta: un ofstream sin abrir no escribe nada
+	ofstream licm;
+	if (licmReport)
+	{
+		licm.open("licm.txt", std::ios::out);
+	}
+
+	CStreamCompiler compiler(stack, functable, out, outopt, licm, methods);
+	int result = parseStream(in, compiler);
+	compileStats.enter(PH_CODEGEN);
+	compiler.finish();
+	out.close();
+	outopt.close();
+	methods.close();
+	licm.close();
+	if (result != 0)
+	{
+		remove(streamMethods);
+		cout << "Parse error, code: " << result << "\nAbort..." << endl;
+		abort();
+	}
+	cout << "Parsing successful" << endl;
+	if (!semantics)
+	{
+		remove(streamMethods);
+		cout << "Semantic errors detected in source code. Aborting..." << endl;
+		return -1;
+	}
+	if (licmReport)
+	{
+		cout << "Saving loop invariant code motion report as \"licm.txt\"" << endl;
+	}
+
+	//Ya se conocen las globales que se asignan y las funciones memoizadas: los campos y
+	//luego los metodos compilados
+	compileStats.enter(PH_CODEGEN);
+	if (emitAsm || emitOptAsm || filter)
+	{
+		CCodeOutput output;
+		ostream code(&output);
+		compileHeader(code, stack);
+		ifstream compiled(streamMethods, std::ios::in | std::ios::binary);
+		code << compiled.rdbuf();
+		compiled.close();
+	}
+	remove(streamMethods);
+	return 0;
+}
+
+/** Escribe las observaciones de las pasadas, si se pidieron con --remarks. **/
+static void writeRemarks()
+{
+	if (!remarks.isEnabled())
+	{
+		return;
+	}
+	cout << "Saving optimization remarks as \"" << remarksPath << "\"" << endl;
+	if (!remarks.write(filename))
+	{
+		cout << "Could not write the remarks file: " << remarksPath << endl;
+	}
+}
+
+/** Imprime las estadisticas de la compilacion y las guarda en JSON, y escribe la traza, si se pidieron. **/
+static void reportStats()
+{
+	if (!compileStats.isEnabled())
+	{
+		return;
+	}
+	compileStats.enter(PH_NONE);
+	if (tracePath != NULL)
+	{
+		cout << "Saving trace as \"" << tracePath << "\"" << endl;
+		if (!tracer.close())
+		{
+			cout << "Could not write the trace file: " << tracePath << endl;
+		}
+	}
+	if (timePasses)
+	{
+		compileStats.report(cout);
+	}
+	if (statsJson != NULL)
+	{
+		cout << "Saving compilation statistics as \"" << statsJson << "\"" << endl;
+		ofstream json(statsJson, std::ios::out);
+		compileStats.writeJson(json, filename);
+	}
+}
+
+/** Analiza en paralelo cada parte del fuente. **/
+class CParseTask : public CParallelTask
+{
+	private:
+		vector<CParseChunk>& chunks;
+	public:
+		CParseTask(vector<CParseChunk>& c) : chunks(c) {}
+
+		void run(int i)
+		{
+			chunks[i].result = parseChunk(&chunks[i]);
+		}
+};
+
+int main(int argc, char* argv[])
+{
+	//Opciones: los argumentos que empiezan con "--", el resto es el archivo de entrada
+	const char* input = NULL;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg(argv[i]);
+		if (arg == "--memoize")
+		{
+			passes.setEnabled("memoize", true);
+		}
+		else if (arg == "--memo-stats")
+		{
+			passes.setEnabled("memoize", true);
+			memoStats = true;
+		}
+		else if (arg.compare(0, 2, "-O") == 0)
+		{
+			if (arg.size() != 3 || !passes.setLevel(arg[2] - '0'))
+			{
+				cout << "Unknown optimization level: " << arg << " (valid levels are -O0 to -O3)" << endl;
+				return -1;
+			}
+		}
+		else if (arg.compare(0, 2, "-f") == 0)
+		{
+			//-f<pasada> la habilita y -fno-<pasada> la deshabilita, sin importar el nivel
+			bool on = (arg.compare(0, 5, "-fno-") != 0);
+			string pass = arg.substr(on ? 2 : 5);
+			if (!passes.setEnabled(pass, on))
+			{
+				cout << "Unknown optimization pass: " << pass << " (see --print-passes)" << endl;
+				return -1;
+			}
+		}
+		else if (arg == "--print-passes")
+		{
+			printPasses = true;
+		}
+		else if (arg == "--licm-report")
+		{
+			licmReport = true;
+		}
+		else if (arg.compare(0, 7, "--jobs=") == 0)
+		{
+			jobs = atoi(arg.substr(7).c_str());
+		}
+		else if (arg == "--dump-tokens")
+		{
+			dumpTokensOnly = true;
+		}
+		else if (arg == "--stream")
+		{
+			stream = true;
+		}
+		else if (arg.compare(0, 7, "--emit=") == 0)
+		{
+			emitAst = emitOptAst = emitAsm = emitOptAsm = false;
+			istringstream kinds(arg.substr(7));
+			string kind;
+			while (getline(kinds, kind, ','))
+			{
+				if (kind == "ast")
+				{
+					emitAst = true;
+				}
+				else if (kind == "opt-ast")
+				{
+					emitOptAst = true;
+				}
+				else if (kind == "asm")
+				{
+					emitAsm = true;
+				}
+				else if (kind == "opt-asm")
+				{
+					emitOptAsm = true;
+				}
+				else
+				{
+					cout << "Unknown output: " << kind << " (valid outputs are ast, opt-ast, asm and opt-asm)" << endl;
+					return -1;
+				}
+			}
+		}
+		else if (arg == "--filter")
+		{
+			filter = true;
+		}
+		else if (arg == "--unbuffered-output")
+		{
+			unbufferedOutput = true;
+		}
+		else if (arg == "--strip-debug")
+		{
+			debugInfo = false;
+		}
+		else if (arg == "--instrument")
+		{
+			instrument = true;
+		}
+		else if (arg == "--time-passes")
+		{
+			timePasses = true;
+		}
+		else if (arg.compare(0, 13, "--stats-json=") == 0)
+		{
+			statsJson = argv[i] + 13;
+		}
+		else if (arg.compare(0, 8, "--trace=") == 0)
+		{
+			tracePath = argv[i] + 8;
+		}
+		else if (arg.compare(0, 10, "--remarks=") == 0)
+		{
+			remarksPath = argv[i] + 10;
+		}
+		else if (arg.compare(0, 2, "--") == 0)
+		{
+			cout << "Unknown option: " << arg << endl;
+			return -1;
+		}
+		else
+		{
+			input = argv[i];
+		}
+	}
+
+	//Solo listar las pasadas, con las opciones dadas
+	if (printPasses)
+	{
+		passes.print(cout);
+		return 0;
+	}
+
+	//Con --filter el codigo optimizado va a la salida estandar y los mensajes a la de errores
+	if (filter)
+	{
+		cout.rdbuf(std::cerr.rdbuf());
+	}
+
+	//Desde aqui se mide cada etapa. La traza registra tambien las etapas que mide compileStats.
+	if (tracePath != NULL)
+	{
+		tracer.open(tracePath);
+	}
+	if (timePasses || statsJson != NULL || tracePath != NULL)
+	{
+		compileStats.enable();
+	}
+	if (remarksPath != NULL)
+	{
+		remarks.open(remarksPath);
+	}
+	compileStats.enter(PH_PARSE);
+
+	//Tomar el primer argumento como entrada, sino stdin.
+	FILE* in = stdin;
+	if (input != NULL)
+	{
+		if (!dumpTokensOnly)
+		{
+			cout << "Batch mode. taking as input: " << input << endl;
+		}
+		in = fopen(input, "rb");
+		filename = input;
+		sourceName = sourcePath(input);
+		if (in == NULL)
+		{
+			cout << "Could not open input file: " << input << endl;
+			return -1;
+		}
+	}
+	else
+	{
+		if (!dumpTokensOnly && !filter)
+		{
+			cout << "Interactive mode. Enter EOF to finish the program.\n"
+			     << "----------------------------------------------" << endl;
+		}
+		filename = "stdin";
+	}
+
+	//Compilar a medida que se lee
+	if (stream && !dumpTokensOnly)
+	{
+		int result = compileStream(in);
+		if (in != stdin)
+		{
+			fclose(in);
+		}
+		compileStats.enter(PH_TEARDOWN);
+		cout << "Freeing used memory..." << endl;
+		delete raiz;
+		writeRemarks();
+		reportStats();
+		return result;
+	}
+
+	//Se necesita toda la entrada, para poder dividirla. Un archivo se mapea en memoria y
+	//los scanners leen directamente de el; stdin se lee completo.
+	string source;
+	const char* data = NULL;
+	int size = 0;
+#ifndef _WIN32
+	void* mapped = MAP_FAILED;
+	struct stat info;
+	if (in != stdin && fstat(fileno(in), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+		if (mapped != MAP_FAILED)
+		{
+			data = (const char*)mapped;
+			size = info.st_size;
+		}
+	}
+#endif
+	if (data == NULL)
+	{
+		char buffer[65536];
+		size_t n;
+		while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		{
+			source.append(buffer, n);
+		}
+		data = source.data();
+		size = source.size();
+	}
+	if (in != stdin)
+	{
+		fclose(in);
+	}
+
+	//Solo listar los tokens de toda la entrada
+	if (dumpTokensOnly)
+	{
+		CParseChunk all;
+		all.text = data;
+		all.size = size;
+		all.firstLine = 1;
+		all.firstColumn = 1;
+		dumpTokens(&all, cout);
+		return 0;
+	}
+
+	//Parsear en paralelo las partes del fuente
+	vector<CParseChunk> chunks;
+	splitSource(data, size, chunks);
+	CParseTask parse(chunks);
+	parallelFor(chunks.size(), parse);
+
+	//Juntar las declaraciones en orden. Como el parser de todo el fuente, se detiene en el primer error
+	int result = 0;
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		if (result == 0)
+		{
+			cout << chunks[i].messages;
+			result = chunks[i].result;
+			raiz->merge(chunks[i].root);
+		}
+		delete chunks[i].root;
+	}
+#ifndef _WIN32
+	if (mapped != MAP_FAILED)
+	{
+		munmap(mapped, size);
+	}
+#endif
+
+	//Imprimir mensaje de salida
+	if (result == 0)
+	{
+		cout << "Parsing successful" << endl;
+		if (compileStats.isEnabled())
+		{
+			raiz->countNodes(compileStats.getNodes());
+		}
+	}
+	else
+	{
+		cout << "Parse error, code: " << result << "\nAbort..." << endl;
+		abort();
+	}
+
+	//Pretty Print
+	compileStats.enter(PH_PRETTY_PRINT);
+	if (emitAst)
+	{
+		cout << "Pretty Printing result. Saving as \"out.txt\"" << endl;
+		ofstream out("out.txt",std::ios::out);
+		raiz->prettyPrint(out,0);
+		out.close();
+	}
+	
+	//Chequear Semantica
+	cout << "Begin semantic validation..." << endl;
+	CPilaDeSimbolos stack;
+	CFunctionTable functable;
+	
+	//Optimizar: pasadas sobre el arbol leido
+	compileStats.enter(PH_OPTIMIZE);
+	cout << "Optimizing..." << endl;
+	raiz->analyzePurity();
+	CPassContext passContext;
+	passContext.root = raiz;
+	passContext.stack = &stack;
+	passContext.functable = &functable;
+	passContext.licm = NULL;
+	passes.run(STAGE_AST, passContext);
+
+	//Pretty Print Optimizado
+	compileStats.enter(PH_PRETTY_PRINT);
+	if (emitOptAst)
+	{
+		cout << "Pretty Printing optimized code. Saving as \"opt.txt\"" << endl;
+		ofstream outopt("opt.txt",std::ios::out);
+		raiz->prettyPrint(outopt,0);
+		outopt.close();
+	}
+
+	//Funciones predefinidas del lenguaje
+	compileStats.enter(PH_SEMANTICS);
+	addBuiltins(functable);
+
+	raiz->checkSemantics(stack, functable);
+	if (semantics && (emitAsm || emitOptAsm || filter))
+	{
+		//Pasadas sobre el arbol validado: versiones de las funciones para llamadas con
+		//argumentos int y expresiones invariantes fuera de los ciclos
+		ostringstream licm;
+		passContext.licm = &licm;
+		passes.run(STAGE_CHECKED, passContext);
+		if (licmReport)
+		{
+			cout << "Saving loop invariant code motion report as \"licm.txt\"" << endl;
+			ofstream report("licm.txt", std::ios::out);
+			report << licm.str();
+			report.close();
+		}
+
+		//Asociar identificadores con variables y mantener en locales las globales de los ciclos
+		compileStats.enter(PH_RESOLVE);
+		raiz->resolve(stack, functable);
+
+		//Cabezal de la clase, variables globales, campos auxiliares y biblioteca estandar
+		//El codigo se guarda y se optimiza a nivel de codigo objeto a medida que se genera
+		compileStats.enter(PH_CODEGEN);
+		cout << "Compiling..." << endl;
+		CCodeOutput output;
+		ostream comp(&output);
+		compileHeader(comp, stack);
+
+		//Compilar si checksemantics todo ok.
+		raiz->compile(comp, functable);
+	}
+	else if (!semantics)
+	{
+		cout << "Semantic errors detected in source code. Aborting..." << endl;
+		result = -1;
+	}
+
+	//Liberar memoria
+	compileStats.enter(PH_TEARDOWN);
+	cout << "Freeing used memory..." << endl;
+	delete raiz;
+
+	writeRemarks();
+	reportStats();
+	return result;
+}
+
+bool isSubStr(const string& str, const char* subStr)
+{
+	return str.find(subStr) != string::npos;
+}
+
+string subStrFromCh(const string& str, char ch)
+{
+	bool existCh = false;
+	string result("");
+
+	for (int i = 0; i < str.size(); i++)
+	{
+		if (str[i] == ch)
+		{
+			existCh = true;
+			continue;
+		}
+
+		if (existCh)
+		{
+			result.append(&str[i]);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,242 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_SAMP_TAB_HPP_INCLUDED
+# define YY_YY_SAMP_TAB_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 71 "samp.y"
+
+
+/*Version 1.3, cambios varios*/
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include <fstream>
+using std::ofstream;
+using std::ifstream;
+using std::istream;
+
+#include <sstream>
+using std::istringstream;
+
+#include "emitter.h"
+
+#include "ast.h"
+extern RootNode* raiz;
+extern const char *filename;
+extern __thread bool semantics;
+
+//Linea actual del scanner, cada hilo que analiza una parte del fuente tiene la suya
+extern __thread int line;
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+/**
+ * @class CSlice
+ * @brief Texto de un token (identificador o cadena) dentro del buffer del scanner, sin copiarlo.
+ **/
+struct CSlice
+{
+	const char* text;
+	int size;
+};
+
+/**
+ * @class CParseChunk
+ * @brief Parte del fuente con una o mas declaraciones completas, que se analiza con su propio scanner.
+ **/
+struct CParseChunk
+{
+	//Texto de la parte, y linea y columna del fuente donde empieza
+	const char* text;
+	int size;
+	int firstLine;
+	int firstColumn;
+	//Declaraciones encontradas, en orden
+	RootNode* root;
+	//Mensajes del scanner y del parser, se imprimen en orden al terminar
+	string messages;
+	int result;
+};
+
+//
+//Scanner. Hay dos implementaciones, que se eligen al compilar (ver LEXER en el Makefile):
+//samp.l, generado con flex, y lexer.cpp, escrito a mano. Ambas deben dar los mismos tokens.
+//
+
+/** Crea un scanner para una parte del fuente. **/
+yyscan_t openScanner(CParseChunk*);
+
+/** Libera un scanner creado con openScanner. **/
+void closeScanner(yyscan_t);
+
+/** Analiza una parte del fuente. **/
+int parseChunk(CParseChunk*);
+
+/** Imprime los tokens de una parte del fuente, con su linea y columna (--dump-tokens). **/
+void dumpTokens(CParseChunk*, ostream&);
+
+
+#line 126 "samp.tab.hpp"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    LPAR = 258,                    /* LPAR  */
+    RPAR = 259,                    /* RPAR  */
+    BOOL = 260,                    /* BOOL  */
+    NUM = 261,                     /* NUM  */
+    REAL = 262,                    /* REAL  */
+    INT = 263,                     /* INT  */
+    FLOAT = 264,                   /* FLOAT  */
+    STRING = 265,                  /* STRING  */
+    VOID = 266,                    /* VOID  */
+    TRUE = 267,                    /* TRUE  */
+    FALSE = 268,                   /* FALSE  */
+    NOT = 269,                     /* NOT  */
+    TIMES = 270,                   /* TIMES  */
+    DIVIDEBY = 271,                /* DIVIDEBY  */
+    PLUS = 272,                    /* PLUS  */
+    MINUS = 273,                   /* MINUS  */
+    ASSIGN = 274,                  /* ASSIGN  */
+    OR = 275,                      /* OR  */
+    AND = 276,                     /* AND  */
+    EQUALS = 277,                  /* EQUALS  */
+    NOTEQUAL = 278,                /* NOTEQUAL  */
+    LESS = 279,                    /* LESS  */
+    LESSEQ = 280,                  /* LESSEQ  */
+    GREATER = 281,                 /* GREATER  */
+    GREATEREQ = 282,               /* GREATEREQ  */
+    IF = 283,                      /* IF  */
+    ELSE = 284,                    /* ELSE  */
+    WHILE = 285,                   /* WHILE  */
+    RETURN = 286,                  /* RETURN  */
+    COLON = 287,                   /* COLON  */
+    LCURL = 288,                   /* LCURL  */
+    RCURL = 289,                   /* RCURL  */
+    SEMICOLON = 290,               /* SEMICOLON  */
+    ID = 291                       /* ID  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 172 "samp.y"
+
+	Statement* statement;
+	StmtIf* stmtIf;
+	StmtWhile* stmtWhile;
+	StmtReturn* stmtReturn;
+	Exp* expr;
+	BinExp* binexpr;
+	UnExp* unexpr;
+	IDNode* id;
+	IntConst* intConst;
+	FloatConst* floatConst;
+	StringConst* strConst;
+	BoolConst* boolConst;
+	ArgsNode* funcDeclArgs;
+	FuncDeclNode *funcDecl;
+	BodyNode* bodyNode;
+	FCallNode* fcallNode;
+	DeclNode* varDecl;
+	list<Exp*>* lparams;
+	list<Statement*>* lstmt;
+	Tipo tipo;
+	int ival;
+	float fval;
+	CSlice slice;
+	bool bval;
+
+#line 206 "samp.tab.hpp"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
+
+
+
+int yyparse (yyscan_t scanner, CParseChunk* chunk);
+
+/* "%code provides" blocks.  */
+#line 148 "samp.y"
+
+
+int yyerror(YYLTYPE*, yyscan_t, CParseChunk*, const char*);
+int yylex(YYSTYPE*, YYLTYPE*, yyscan_t);
+
+
+#line 241 "samp.tab.hpp"
+
+#endif /* !YY_YY_SAMP_TAB_HPP_INCLUDED  */
@@ -18,10 +18,53 @@
 
 %{
 
+#include <cstring>
+#include <cstdlib>
 #include "ast.h"
+#include "parallel.h"
+#include "stats.h"
+#include "trace.h"
+#include "passes.h"
+#include "remarks.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 RootNode* raiz = new RootNode();
-bool semantics = true;
+//Cada hilo que valida funciones tiene su propia bandera
+__thread bool semantics = true;
+//Opciones del compilador. Las pasadas de optimizacion habilitadas estan en passes.
+bool memoStats = false;
+bool licmReport = false;
+int jobs = 0;
+bool dumpTokensOnly = false;
+bool printPasses = false;
+bool stream = false;
+bool filter = false;
+bool unbufferedOutput = false;
+//Tablas de lineas y de variables locales y ruta completa del fuente (sin --strip-debug)
+bool debugInfo = true;
+//Contadores de llamadas y de iteraciones en el codigo generado (--instrument)
+bool instrument = false;
+//Estadisticas de la compilacion (--time-passes y --stats-json)
+bool timePasses = false;
+const char* statsJson = NULL;
+//Traza de las pasadas en formato de Chrome (--trace)
+const char* tracePath = NULL;
+//Observaciones de las pasadas de optimizacion en YAML (--remarks)
+const char* remarksPath = NULL;
+//Archivos a generar (--emit)
+bool emitAst = false;
+bool emitOptAst = false;
+bool emitAsm = false;
+bool emitOptAsm = true;
 const char *filename;
+//Nombre del fuente en .source
+string sourceName = "stdin";
+
+//Los operadores asocian a derecha, por lo que una cadena de N terminos deja N simbolos
+//en la pila del parser hasta reducirla. Esa pila crece en el heap, no en la nativa.
+#define YYMAXDEPTH 50000000
 
 %}
 
@@ -35,22 +78,97 @@ using std::endl;
 #include <fstream>
 using std::ofstream;
 using std::ifstream;
+using std::istream;
+
+#include <sstream>
+using std::istringstream;
+
+#include "emitter.h"
 
 #include "ast.h"
 extern RootNode* raiz;
 extern const char *filename;
-extern bool semantics;
+extern __thread bool semantics;
+
+//Linea actual del scanner, cada hilo que analiza una parte del fuente tiene la suya
+extern __thread int line;
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+/**
+ * @class CSlice
+ * @brief Texto de un token (identificador o cadena) dentro del buffer del scanner, sin copiarlo.
+ **/
+struct CSlice
+{
+	const char* text;
+	int size;
+};
+
+/**
+ * @class CParseChunk
+ * @brief Parte del fuente con una o mas declaraciones completas, que se analiza con su propio scanner.
+ **/
+struct CParseChunk
+{
+	//Texto de la parte, y linea y columna del fuente donde empieza
+	const char* text;
+	int size;
+	int firstLine;
+	int firstColumn;
+	//Declaraciones encontradas, en orden
+	RootNode* root;
+	//Mensajes del scanner y del parser, se imprimen en orden al terminar
+	string messages;
+	int result;
+};
+
+//
+//Scanner. Hay dos implementaciones, que se eligen al compilar (ver LEXER en el Makefile):
+//samp.l, generado con flex, y lexer.cpp, escrito a mano. Ambas deben dar los mismos tokens.
+//
+
+/** Crea un scanner para una parte del fuente. **/
+yyscan_t openScanner(CParseChunk*);
+
+/** Libera un scanner creado con openScanner. **/
+void closeScanner(yyscan_t);
+
+/** Analiza una parte del fuente. **/
+int parseChunk(CParseChunk*);
+
+/** Imprime los tokens de una parte del fuente, con su linea y columna (--dump-tokens). **/
+void dumpTokens(CParseChunk*, ostream&);
 
-extern FILE* yyin;
-extern int line;
+}
 
-int yyerror(char*);
-int yylex(void);
-int yyparse(void);
+%code provides{
 
+int yyerror(YYLTYPE*, yyscan_t, CParseChunk*, const char*);
+int yylex(YYSTYPE*, YYLTYPE*, yyscan_t);
 
 }
 
+%code{
+
+/** Copia el texto de un token al construir el nodo que lo guarda. **/
+static string text(CSlice s)
+{
+	return string(s.text, s.size);
+}
+
+}
+
+%define api.pure
+%locations
+%token-table
+%parse-param {yyscan_t scanner}
+%parse-param {CParseChunk* chunk}
+%lex-param {yyscan_t scanner}
+
 %union{
 	Statement* statement;
 	StmtIf* stmtIf;
@@ -74,7 +192,7 @@ int yyparse(void);
 	Tipo tipo;
 	int ival;
 	float fval;
-	char* cpval;
+	CSlice slice;
 	bool bval;
 }
 
@@ -90,8 +208,8 @@ int yyparse(void);
 %type <lstmt> stmtlst
 %type <ival> NUM
 %type <fval> REAL
-%type <cpval> ID 
-%type <cpval> STRING
+%type <slice> ID 
+%type <slice> STRING
 %type <bval> TRUE FALSE
 
 %start prog
@@ -112,25 +230,25 @@ int yyparse(void);
 
 %%
 
-prog	:	function				{ raiz->append($1); }
-	|	function prog				{ raiz->append($1); }
-	|	declaration				{ raiz->append($1); }
-	|	declaration prog				{ raiz->append($1); }
+prog	:	function				{ chunk->root->append($1); }
+	|	function prog				{ chunk->root->append($1); }
+	|	declaration				{ chunk->root->append($1); }
+	|	declaration prog				{ chunk->root->append($1); }
 
-function :	type ID LPAR args RPAR body		{ $$ = new FuncDeclNode($1,new IDNode($2),$4,$6); delete[] $2;}
-	 |	type ID LPAR RPAR body			{ $$ = new FuncDeclNode($1,new IDNode($2),NULL,$5); delete[] $2; }
+function :	type ID LPAR args RPAR body		{ $$ = new FuncDeclNode($1,new IDNode(text($2)),$4,$6); $$->setDeclLine(@2.first_line); }
+	 |	type ID LPAR RPAR body			{ $$ = new FuncDeclNode($1,new IDNode(text($2)),NULL,$5); $$->setDeclLine(@2.first_line); }
 
-declaration :	type ID SEMICOLON			{ $$ = new DeclNode($1,new IDNode($2),NULL); delete[] $2; }
-	    |	type ID ASSIGN exp SEMICOLON		{ $$ = new DeclNode($1,new IDNode($2),$4); delete[] $2; }
+declaration :	type ID SEMICOLON			{ $$ = new DeclNode($1,new IDNode(text($2)),NULL); }
+	    |	type ID ASSIGN exp SEMICOLON		{ $$ = new DeclNode($1,new IDNode(text($2)),$4); }
 
 args	:	type ID					{  list< pair<Tipo,IDNode*> >* l = new list< pair<Tipo,IDNode*> >();
-							   pair<Tipo,IDNode*> p; p.first = $1; p.second = new IDNode($2);
+							   pair<Tipo,IDNode*> p; p.first = $1; p.second = new IDNode(text($2));
 							   l->push_front(p);
-							   $$ = new ArgsNode(l); delete[] $2;
+							   $$ = new ArgsNode(l);
 							}
-	|	type ID COLON args			{  pair<Tipo, IDNode*> p; p.first = $1; p.second = new IDNode($2);
+	|	type ID COLON args			{  pair<Tipo, IDNode*> p; p.first = $1; p.second = new IDNode(text($2));
 							   $4->getList()->push_front(p);
-							   $$ = $4; delete[] $2;
+							   $$ = $4;
 							}
 
 params	:	exp					{ list<Exp*>* l = new list<Exp*>(); l->push_front($1); $$ = l;}
@@ -155,8 +273,8 @@ exp	:	NUM					{ $$ = new IntConst($1); }
 	|	exp LESSEQ exp			{ $$ = new BinExp(OP_LESSEQ, $1, $3); }
 	|	exp GREATER exp			{ $$ = new BinExp(OP_GREATER, $1, $3); }
 	|	exp GREATEREQ exp			{ $$ = new BinExp(OP_GREATEREQ, $1, $3); }
-	|	ID					{ $$ = new IDNode($1); delete[] $1;}
-	|	STRING					{ $$ = new StringConst($1); delete[] $1;}
+	|	ID					{ $$ = new IDNode(text($1)); }
+	|	STRING					{ $$ = new StringConst(text($1)); }
 	|	fcall					{ FCallNode* fcalln = $1; fcalln->setStmt(false); $$ = $1; }
 
 
@@ -169,15 +287,15 @@ stmt	:	declaration				{ $$ = $1; }
 	|	WHILE LPAR exp RPAR stmt		{ $$ = new StmtWhile($3,$5); }
 	|	body					{ $$ = $1; }
 	|	fcall SEMICOLON			{ $$ = $1; }
-	|	ID ASSIGN exp SEMICOLON		{ $$ = new AssignNode(new IDNode($1),$3); delete[] $1;}
+	|	ID ASSIGN exp SEMICOLON		{ $$ = new AssignNode(new IDNode(text($1)),$3); }
 	|	RETURN exp SEMICOLON		{ $$ = new StmtReturn($2); }
 	|	RETURN SEMICOLON			{ $$ = new StmtReturn(NULL); }
 
 body	:	LCURL stmtlst RCURL			{ $$ = new BodyNode($2); }
 	|	LCURL RCURL				{ $$ = new BodyNode(NULL); }
 
-fcall	:	ID LPAR params RPAR			{ $$ = new FCallNode(new IDNode($1),$3); delete[] $1;}
-	|	ID LPAR RPAR				{ $$ = new FCallNode(new IDNode($1),NULL); delete[] $1;}
+fcall	:	ID LPAR params RPAR			{ $$ = new FCallNode(new IDNode(text($1)),$3); }
+	|	ID LPAR RPAR				{ $$ = new FCallNode(new IDNode(text($1)),NULL); }
 
 type	:	BOOL					{ $$ = TBOOL; }
 	|	INT					{ $$ = TINT; }
@@ -186,85 +304,574 @@ type	:	BOOL					{ $$ = TBOOL; }
 	|	VOID					{ $$ = TVOID; }
 
 %%
-void peephole(string, string);
-bool isSubStr(string str, string subStr);
-string subStrFromCh(string str, char ch);
+bool isSubStr(const string& str, const char* subStr);
+string subStrFromCh(const string& str, char ch);
 
-int yyerror(char *s)
+int yyerror(YYLTYPE*, yyscan_t, CParseChunk* chunk, const char*)
 {
-	printf("Grammar error: line[%d]\n", line);
+	ostringstream msg;
+	msg << "Grammar error: line[" << line << "]\n";
+	chunk->messages += msg.str();
 	return 0;
 }
 
-int main(int argc, char* argv[])
+//Tamano minimo de cada parte del fuente que se analiza en paralelo
+const int minChunkSize = 16384;
+
+/**
+ * @class CSplitState
+ * @brief Estado de la busqueda de los fines de declaracion en el fuente (ver nextDeclarationEnd).
+ **/
+struct CSplitState
 {
-	
-	//Tomar el primer argumento como entrada, sino stdin.
-	if (argc > 1)
+	//Proximo caracter a revisar y bloques abiertos
+	int pos;
+	int depth;
+	//Linea actual y posicion del ultimo salto de linea contado, para las columnas
+	int line;
+	int newline;
+	//Se cerro una llave de mas: ya no se puede cortar en ningun lado
+	bool unbalanced;
+};
+
+/**
+ * Busca donde termina la proxima declaracion global o funcion: en un ';' o una '}' fuera de
+ * todo bloque. Se saltean las cadenas y los comentarios, y las lineas y columnas se cuentan
+ * como en el scanner: los saltos de linea dentro de una cadena no cuentan. Devuelve la
+ * posicion siguiente al fin, o -1 si no hay mas. Si more es true, falta leer parte del fuente:
+ * se detiene antes de una cadena o un comentario que puede terminar en lo que falta.
+ **/
+static int nextDeclarationEnd(const char* source, int size, bool more, CSplitState& state)
+{
+	while (!state.unbalanced && state.pos < size)
 	{
-		cout << "Batch mode. taking as input: " << argv[1] << endl;
-		yyin = fopen(argv[1],"r+");
-		filename = argv[1];
+		int i = state.pos;
+		char c = source[i];
+		if (c == '\n')
+		{
+			state.line++;
+			state.newline = i;
+		}
+		else if (c == '"')
+		{
+			//Una comilla sin cerrar no es una cadena para el scanner
+			const char* close = (const char*)memchr(source + i + 1, '"', size - i - 1);
+			if (close != NULL)
+			{
+				i = close - source;
+			}
+			else if (more)
+			{
+				return -1;
+			}
+		}
+		else if (c == '/' && (i + 1 < size || more))
+		{
+			if (i + 1 == size)
+			{
+				return -1;
+			}
+			if (source[i + 1] == '/')
+			{
+				//El salto de linea que termina el comentario se cuenta en la siguiente vuelta
+				const char* eol = (const char*)memchr(source + i, '\n', size - i);
+				if (eol == NULL && more)
+				{
+					return -1;
+				}
+				i = (eol == NULL) ? size - 1 : eol - source - 1;
+			}
+		}
+		else if (c == '{')
+		{
+			state.depth++;
+		}
+		else if (c == '}' || c == ';')
+		{
+			if (c == '}' && --state.depth < 0)
+			{
+				//Llaves desbalanceadas: el resto va junto y el parser dara el error
+				state.unbalanced = true;
+				return -1;
+			}
+			if (state.depth == 0)
+			{
+				state.pos = i + 1;
+				return i + 1;
+			}
+		}
+		state.pos = i + 1;
 	}
-	else
+	return -1;
+}
+
+/** Divide el fuente en partes que terminan donde termina una declaracion global o una funcion. **/
+static void splitSource(const char* source, int size, vector<CParseChunk>& chunks)
+{
+	int parts = getThreadCount();
+	if (parts > size / minChunkSize)
 	{
-		cout << "Interactive mode. Enter EOF or a grammar error to quit.\n"
-		     << "----------------------------------------------" << endl;
-		yyin = stdin;
-		filename = "stdin";
+		parts = size / minChunkSize;
 	}
-	/*
-	int result = 0;
-	//Parsear entrada
-	for (int i = 1; i < argc; i++)
+
+	//Fin de cada declaracion, y linea y ultimo salto de linea antes de lo que sigue
+	vector<int> ends;
+	vector<int> lines;
+	vector<int> newlines;
+	CSplitState state = {0, 0, 1, -1, false};
+	int end;
+	while (parts > 1 && (end = nextDeclarationEnd(source, size, false, state)) >= 0)
 	{
-		yyin = fopen(argv[i],"r+");
-		int tmp = yyparse();
-		if (result == 0)
+		ends.push_back(end);
+		lines.push_back(state.line);
+		newlines.push_back(state.newline);
+	}
+
+	//Se corta en la declaracion que termina mas cerca de cada fraccion del fuente. Lo que
+	//sigue a la ultima declaracion queda con ella, asi ninguna parte queda sin declaraciones.
+	int start = 0;
+	int startLine = 1;
+	int startColumn = 1;
+	unsigned int e = 0;
+	unsigned int cuts = ends.empty() ? 0 : ends.size() - 1;
+	for (int p = 1; p < parts; p++)
+	{
+		int target = (int)(size * (double)p / parts);
+		while (e < cuts && ends[e] < target)
 		{
-			result = tmp;
+			e++;
 		}
-		fclose(yyin);
-	}*/
-	int result = yyparse();
+		if (e == cuts)
+		{
+			break;
+		}
+		CParseChunk chunk;
+		chunk.text = source + start;
+		chunk.size = ends[e] - start;
+		chunk.firstLine = startLine;
+		chunk.firstColumn = startColumn;
+		chunks.push_back(chunk);
+		start = ends[e];
+		startLine = lines[e];
+		startColumn = start - newlines[e];
+		e++;
+	}
+	CParseChunk last;
+	last.text = source + start;
+	last.size = size - start;
+	last.firstLine = startLine;
+	last.firstColumn = startColumn;
+	chunks.push_back(last);
+
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		chunks[i].root = new RootNode();
+		chunks[i].result = 0;
+	}
+}
 
-	//Imprimir mensaje de salida
-	if (result == 0)
+//Tamano de cada lectura del fuente al compilar a medida que se lee (--stream)
+const int streamBlockSize = 65536;
+
+/** Analiza una parte del fuente y pasa sus declaraciones, en orden, al compilador. **/
+static int parseDeclarations(const char* text, int size, int firstLine, int firstColumn, CStreamCompiler& compiler)
+{
+	CParseChunk chunk;
+	chunk.text = text;
+	chunk.size = size;
+	chunk.firstLine = firstLine;
+	chunk.firstColumn = firstColumn;
+	chunk.root = new RootNode();
+	chunk.result = parseChunk(&chunk);
+	cout << chunk.messages;
+	if (chunk.result == 0)
 	{
-		cout << "Parsing successful" << endl;
+		Node* node;
+		while ((node = chunk.root->takeFirst()) != NULL)
+		{
+			compiler.add(node);
+		}
 	}
-	else
+	delete chunk.root;
+	return chunk.result;
+}
+
+/**
+ * Lee el fuente de a bloques y analiza cada declaracion apenas termina de leerla. Cada una
+ * se analiza al encontrar el fin de la siguiente, asi lo que sigue a la ultima queda con ella.
+ * En memoria solo quedan las declaraciones que faltan analizar. Como el parser de todo el
+ * fuente, se detiene en el primer error.
+ **/
+static int parseStream(FILE* in, CStreamCompiler& compiler)
+{
+	//Texto leido y no analizado: empieza en start, y la declaracion retenida termina en held
+	string pending;
+	int start = 0;
+	int held = -1;
+	int heldLine = 1;
+	int heldNewline = -1;
+	int firstLine = 1;
+	int firstColumn = 1;
+	CSplitState state = {0, 0, 1, -1, false};
+	vector<char> buffer(streamBlockSize);
+	bool more = true;
+	while (true)
 	{
-		cout << "Parse error, code: " << result << "\nAbort..." << endl;
-		abort();
+		int end = nextDeclarationEnd(pending.data(), pending.size(), more, state);
+		if (end < 0)
+		{
+			if (!more)
+			{
+				break;
+			}
+			//Se descarta lo ya analizado antes de leer mas, si es al menos la mitad del texto
+			if (start > 0 && start >= (int)pending.size() / 2)
+			{
+				pending.erase(0, start);
+				state.pos -= start;
+				state.newline -= start;
+				held -= (held >= 0) ? start : 0;
+				heldNewline -= start;
+				start = 0;
+			}
+			size_t n = fread(&buffer[0], 1, buffer.size(), in);
+			pending.append(&buffer[0], n);
+			more = (n > 0);
+			continue;
+		}
+		if (held >= 0)
+		{
+			int result = parseDeclarations(pending.data() + start, held - start, firstLine, firstColumn, compiler);
+			if (result != 0)
+			{
+				return result;
+			}
+			start = held;
+			firstLine = heldLine;
+			firstColumn = held - heldNewline;
+		}
+		held = end;
+		heldLine = state.line;
+		heldNewline = state.newline;
 	}
+	return parseDeclarations(pending.data() + start, pending.size() - start, firstLine, firstColumn, compiler);
+}
 
-	//Pretty Print
-	cout << "Pretty Printing result. Saving as \"out.txt\"" << endl;
-	ofstream out("out.txt",std::ios::out);
-	raiz->prettyPrint(out,0);
-	out.close();
-	
-	//Chequear Semantica
-	cout << "Begin semantic validation..." << endl;
-	CPilaDeSimbolos stack;
-	CFunctionTable functable;
-	
-	//Optimizar
-	cout << "Optimizing..." << endl;
-	raiz->optimize();
+int parseChunk(CParseChunk* chunk)
+{
+	yyscan_t scanner = openScanner(chunk);
+	if (scanner == NULL)
+	{
+		return -1;
+	}
+	int result = yyparse(scanner, chunk);
+	closeScanner(scanner);
+	return result;
+}
 
-	//Pretty Print Optimizado
-	cout << "Pretty Printing optimized code. Saving as \"opt.txt\"" << endl;
-	ofstream outopt("opt.txt",std::ios::out);
-	raiz->prettyPrint(outopt,0);
-	out.close();
+/** Nombre de un token en la gramatica. **/
+static const char* tokenName(int token)
+{
+	return yytname[YYTRANSLATE(token)];
+}
 
-	//Funciones predefinidas del lenguaje
+void dumpTokens(CParseChunk* chunk, ostream& out)
+{
+	yyscan_t scanner = openScanner(chunk);
+	if (scanner == NULL)
+	{
+		return;
+	}
+	YYSTYPE value;
+	YYLTYPE location;
+	value.slice.text = NULL;
+	int token;
+	while ((token = yylex(&value, &location, scanner)) != 0)
+	{
+		//Los caracteres no reconocidos antes del token
+		out << chunk->messages;
+		chunk->messages.clear();
+
+		out << location.first_line << ":" << location.first_column << " " << tokenName(token);
+		switch (token)
+		{
+			case ID:
+			case STRING:
+				//STRING es tambien el tipo: solo la cadena tiene texto
+				if (value.slice.text != NULL)
+				{
+					out << " " << text(value.slice);
+				}
+				break;
+			case NUM:
+				out << " " << value.ival;
+				break;
+			case REAL:
+				out << " " << value.fval;
+				break;
+			case TRUE:
+			case FALSE:
+				out << " " << value.bval;
+				break;
+		}
+		out << "\n";
+		value.slice.text = NULL;
+	}
+	out << chunk->messages;
+	chunk->messages.clear();
+	closeScanner(scanner);
+}
+
+/**
+ * @class CPeephole
+ * @brief Optimizacion a nivel de codigo objeto sobre cada par de lineas del codigo jasmin:
+ * un store seguido de un load de la misma variable pasa a ser un dup y el store. Las lineas
+ * de depuracion (.line, .var y las etiquetas Scope de las variables) no separan el par, ya
+ * que no generan codigo ni son destino de saltos. Sin la pasada peephole (-O0 o
+ * -fno-peephole) copia las lineas tal cual.
+ **/
+class CPeephole
+{
+	private:
+		ostream& out;
+		//Se reusan para todas las lineas
+		string oldLine;
+		string newLine;
+		//Lineas de depuracion que siguen a oldLine
+		string debugLines;
+		bool first;
+		bool active;
+
+		/** Indica si la linea es de depuracion: .line, .var o una etiqueta Scope. **/
+		static bool isDebugLine(const char* text, int size)
+		{
+			return (size > 6 && strncmp(text, ".line ", 6) == 0) || (size > 5 && strncmp(text, ".var ", 5) == 0) ||
+				(size > 5 && strncmp(text, "Scope", 5) == 0);
+		}
+	public:
+		CPeephole(ostream& o) : out(o), first(true), active(passes.isEnabled(PASS_PEEPHOLE)) {}
+
+		/** Recibe la proxima linea y escribe la anterior, ya optimizada. **/
+		void add(const char* text, int size)
+		{
+			if (!active)
+			{
+				out.write(text, size);
+				out.put('\n');
+				return;
+			}
+			if (!first && isDebugLine(text, size))
+			{
+				debugLines.append(text, size);
+				debugLines += '\n';
+				return;
+			}
+			if (first)
+			{
+				oldLine.assign(text, size);
+				first = false;
+				return;
+			}
+
+			newLine.assign(text, size);
+			if ( (oldLine.size() > 0) && (newLine.size() > 0) && isSubStr(oldLine, "store") && isSubStr(newLine, "load") )
+			{
+				//Compara el segundo caracter (el 1ero es el tipo...), de las dos lineas para ver si coinciden.
+				if (oldLine[1] == newLine[1])
+				{
+					string idAssemStore = subStrFromCh(oldLine, ' ');
+					string idAssemLoad = subStrFromCh(newLine, '_');
+
+					//Verifica que el store y el load sean sobre la misma variable
+					if (idAssemStore == idAssemLoad)
+					{
+						out << "\tdup\n";
+						newLine = "\t;Store optimizado por PeepHole";
+					}
+				}
+			}
+
+			out.write(oldLine.data(), oldLine.size());
+			out.put('\n');
+			out << debugLines;
+			debugLines.clear();
+			oldLine.swap(newLine);
+		}
+
+		/** Escribe la ultima linea. **/
+		void finish()
+		{
+			if (!active)
+			{
+				out.flush();
+				return;
+			}
+			out << oldLine << "\n" << debugLines;
+			out.flush();
+		}
+};
+
+/**
+ * @class CCodeOutput
+ * @brief Ultimas etapas del codigo jasmin, encadenadas en memoria: lo que se escribe en este
+ * buffer se guarda tal cual en comp.j (--emit=asm) y pasa por la optimizacion peephole hacia
+ * compopt.j (--emit=opt-asm), o hacia la salida estandar con --filter. Las lineas completas se
+ * procesan cada vez que se llena el bloque.
+ **/
+class CCodeOutput : public streambuf
+{
+	private:
+		CEmitter asmFile;
+		CEmitter optFile;
+		CPeephole* peephole;
+		vector<char> buffer;
+
+		/** Pasa las lineas completas del texto por peephole y a comp.j. Devuelve el fin de la ultima. **/
+		const char* processLines(const char* begin, const char* end)
+		{
+			const char* lineStart = begin;
+			const char* lineEnd;
+			while ((lineEnd = (const char*)memchr(lineStart, '\n', end - lineStart)) != NULL)
+			{
+				if (peephole != NULL)
+				{
+					peephole->add(lineStart, lineEnd - lineStart);
+				}
+				lineStart = lineEnd + 1;
+			}
+			if (emitAsm)
+			{
+				asmFile.write(begin, lineStart - begin);
+			}
+			return lineStart;
+		}
+
+		/** Procesa las lineas completas, la ultima que no lo esta queda al principio del bloque. **/
+		void process(bool last)
+		{
+			EPhase phase = compileStats.enter(PH_PEEPHOLE);
+			char* end = pptr();
+			const char* lineStart = processLines(pbase(), end);
+			if (last && lineStart < end)
+			{
+				if (peephole != NULL)
+				{
+					peephole->add(lineStart, end - lineStart);
+				}
+				if (emitAsm)
+				{
+					asmFile.write(lineStart, end - lineStart);
+					asmFile.put('\n');
+				}
+				lineStart = end;
+			}
+
+			//Una linea que ocupa todo el bloque no se puede procesar todavia, se agranda el bloque
+			int rest = end - lineStart;
+			memmove(&buffer[0], lineStart, rest);
+			if (rest == (int)buffer.size())
+			{
+				buffer.resize(buffer.size() * 2);
+			}
+			setp(&buffer[0], &buffer[0] + buffer.size());
+			pbump(rest);
+			compileStats.enter(phase);
+		}
+	protected:
+		int overflow(int c)
+		{
+			process(false);
+			if (c != EOF)
+			{
+				*pptr() = c;
+				pbump(1);
+			}
+			return 0;
+		}
+
+		/**
+		 * Un texto que no entra en el bloque (ej. el codigo de un metodo) se procesa en su lugar:
+		 * solo se copian la parte que completa la linea pendiente del bloque y la ultima linea
+		 * incompleta, y comp.j lo recibe sin copiar.
+		 **/
+		streamsize xsputn(const char* s, streamsize n)
+		{
+			if (n <= epptr() - pptr())
+			{
+				memcpy(pptr(), s, n);
+				pbump(n);
+				return n;
+			}
+			const char* newline = (const char*)memchr(s, '\n', n);
+			if (newline == NULL)
+			{
+				return streambuf::xsputn(s, n);
+			}
+			EPhase phase = compileStats.enter(PH_PEEPHOLE);
+			streambuf::xsputn(s, newline + 1 - s);
+			process(false);
+			const char* rest = processLines(newline + 1, s + n);
+			streambuf::xsputn(rest, s + n - rest);
+			compileStats.enter(phase);
+			return n;
+		}
+	public:
+		CCodeOutput() : peephole(NULL), buffer(emitBufferSize)
+		{
+			setp(&buffer[0], &buffer[0] + buffer.size());
+			if (emitAsm)
+			{
+				cout << "Saving object code as \"comp.j\"" << endl;
+				asmFile.open("comp.j");
+			}
+			if (filter)
+			{
+				optFile.attach(1);
+				peephole = new CPeephole(optFile);
+			}
+			else if (emitOptAsm)
+			{
+				cout << "Optimizing object code. Saving as \"compopt.j\"" << endl;
+				optFile.open("compopt.j");
+				peephole = new CPeephole(optFile);
+			}
+		}
+
+		~CCodeOutput()
+		{
+			EPhase phase = compileStats.enter(PH_PEEPHOLE);
+			process(true);
+			if (peephole != NULL)
+			{
+				peephole->finish();
+				delete peephole;
+			}
+			asmFile.close();
+			optFile.close();
+			compileStats.enter(phase);
+		}
+};
+
+/** Registra las funciones predefinidas del lenguaje. **/
+static void addBuiltins(CFunctionTable& functable)
+{
 	list<Tipo> args;
 	args.push_back(TSTRING);
 	functable.addFunction(TVOID, "print", args);
 
+	//print tambien tiene versiones para cada tipo primitivo en lpstdlib.j
+	args.clear();
+	args.push_back(TINT);
+	functable.addOverload(TVOID, "print", args);
+
+	args.clear();
+	args.push_back(TFLOAT);
+	functable.addOverload(TVOID, "print", args);
+
+	args.clear();
+	args.push_back(TBOOL);
+	functable.addOverload(TVOID, "print", args);
+
 	args.clear();
 	args.push_back(TFLOAT);
 	functable.addFunction(TINT, "trunc", args);
@@ -280,138 +887,600 @@ int main(int argc, char* argv[])
 	args.clear();
 	functable.addFunction(TSTRING, "read", args);
 
-	raiz->checkSemantics(stack, functable);
-	if (semantics)
-	{
-		cout << "Compiling into file \"comp.j\"" << endl;
-		//Crear archivo de salida
-		ofstream comp("comp.j", std::ios::out);
+	//Lectura directa del buffer de stdin, sin pasar por un string
+	args.clear();
+	functable.addFunction(TINT, "readInt", args);
 
-		//Crear cabezal de clase estatica generada
-		comp << ".source " << filename << "\n";
-		comp << ".class " << className << "\n";
-		comp << ".super java/lang/Object\n\n";
+	args.clear();
+	functable.addFunction(TFLOAT, "readFloat", args);
+
+	args.clear();
+	functable.addFunction(TSTRING, "readAll", args);
+}
 
-		//Compilar las variables globales
-		for (list< CNodoPila >::iterator it = stack.getLista().begin(); it != stack.getLista().end(); it++)
+/**
+ * Nombre del fuente para .source: la ruta completa, para que los perfiladores y depuradores
+ * encuentren el archivo, o tal cual se recibio con --strip-debug o si no se puede resolver.
+ **/
+static string sourcePath(const char* file)
+{
+	string path = file;
+	if (debugInfo)
+	{
+#ifndef _WIN32
+		char* full = realpath(file, NULL);
+#else
+		char* full = _fullpath(NULL, file, 0);
+#endif
+		if (full != NULL)
 		{
-			comp << ".field public static "<< it->GetID() << " " <<  util::compile(util::Tipo2ExpType(it->GetTipoDato())) << "\n";
+			path = full;
+			free(full);
 		}
+	}
+	//jasmin separa las palabras por espacios
+	if (path.find_first_of(" \t") != string::npos)
+	{
+		path = "\"" + path + "\"";
+	}
+	return path;
+}
 
-		//Copiar biblioteca Estandar
-		ifstream in("lpstdlib.j");
-		if (!in)
+/**
+ * Compila lo que va antes del codigo de usuario: el cabezal de la clase, las variables
+ * globales, los campos auxiliares de las funciones y la biblioteca estandar.
+ **/
+static void compileHeader(ostream& comp, CPilaDeSimbolos& stack)
+{
+	//Crear cabezal de clase estatica generada
+	comp << ".source " << sourceName << "\n";
+	comp << ".class " << className << "\n";
+	comp << ".super java/lang/Object\n\n";
+
+	//Compilar las variables globales. Las que nunca se asignan conservan su valor inicial
+	//y se declaran final, para que la JVM pueda tratarlas como constantes.
+	for (list< CNodoPila >::iterator it = stack.getLista().begin(); it != stack.getLista().end(); it++)
+	{
+		Tipo t = it->GetTipoDato();
+		if (!it->EsAsignada() && t != TSTRING)
+		{
+			comp << ".field public static final "<< it->GetID() << " " <<  util::compile(util::Tipo2ExpType(t)) << " = " << (t == TFLOAT ? "0.0" : "0") << "\n";
+		}
+		else
 		{
-			cout << "Error: standar library (lpstdlib.j) missing.\nAborting..." << endl;
-			abort();
+			comp << ".field public static "<< it->GetID() << " " <<  util::compile(util::Tipo2ExpType(t)) << "\n";
 		}
+	}
+
+	//Compilar los campos auxiliares de las funciones (caches de memoizacion)
+	raiz->compileFields(comp);
+
+	//Copiar biblioteca Estandar
+	EPhase phase = compileStats.enter(PH_STDLIB);
+	ifstream in("lpstdlib.j");
+	if (!in)
+	{
+		cout << "Error: standar library (lpstdlib.j) missing.\nAborting..." << endl;
+		abort();
+	}
 
-		while (!in.eof())
+	//Las directivas .line y .var de la biblioteca son lineas de lpstdlib.j, que los perfiladores
+	//atribuirian al fuente del usuario (.source): se copia sin ellas
+	string text;
+	while (getline(in, text))
+	{
+		size_t start = text.find_first_not_of(" \t");
+		if (start == string::npos || (text.compare(start, 6, ".line ") != 0 && text.compare(start, 5, ".var ") != 0))
 		{
-			string s;
-			getline(in, s);
-			comp << s << "\n";
+			comp << text << "\n";
 		}
-	
-		comp << ";\n; Codigo de usuario\n;\n";
+	}
+	comp << "\n";
+	compileStats.enter(phase);
 
-		//Compilar si checksemantics todo ok.
-		raiz->compile(comp, stack, functable);
+	comp << ";\n; Codigo de usuario\n;\n";
+}
 
-		//Cerrar archivos
-		out.close();
-		outopt.close();
-		comp.close();
+/**
+ * Compila cada declaracion apenas se lee (--stream), en lugar de analizar todo el fuente
+ * antes de compilarlo. La memoria usada depende de la funcion mas grande y no del fuente.
+ **/
+static int compileStream(FILE* in)
+{
+	cout << "Streaming mode: each declaration is compiled as soon as it is parsed." << endl;
+	CPilaDeSimbolos stack;
+	CFunctionTable functable;
+	addBuiltins(functable);
 
-		//Optimizacion a nivel de codigo objeto
-		cout << "Optimizing object code. Saving as \"compopt.j\"" << endl;
-		peephole("comp.j", "compopt.j");
+	//Como con licm.txt, lo que no se pidio con --emit va a un ofstream sin abrir
+	ofstream out;
+	ofstream outopt;
+	if (emitAst)
+	{
+		out.open("out.txt", std::ios::out);
+	}
+	if (emitOptAst)
+	{
+		outopt.open("opt.txt", std::ios::out);
+	}
+	//Los metodos se compilan en memoria hasta conocer los campos, que van antes
+	CEmitter methods(emitBufferSize);
+	//Sin --licm-report el reporte se descarta: un ofstream sin abrir no escribe nada
+	ofstream licm;
+	if (licmReport)
+	{
+		licm.open("licm.txt", std::ios::out);
+	}
 
+	CStreamCompiler compiler(stack, functable, out, outopt, licm, methods);
+	int result = parseStream(in, compiler);
+	compileStats.enter(PH_CODEGEN);
+	compiler.finish();
+	out.close();
+	outopt.close();
+	licm.close();
+	if (result != 0)
+	{
+		cout << "Parse error, code: " << result << "\nAbort..." << endl;
+		abort();
 	}
-	else
+	cout << "Parsing successful" << endl;
+	if (!semantics)
 	{
 		cout << "Semantic errors detected in source code. Aborting..." << endl;
-		result = -1;
+		return -1;
+	}
+	if (licmReport)
+	{
+		cout << "Saving loop invariant code motion report as \"licm.txt\"" << endl;
 	}
 
-	//Liberar memoria
-	cout << "Freeing used memory..." << endl;
-	delete raiz;
-
-	//out.close();
-	//outopt.close();
+	//Ya se conocen las globales que se asignan y las funciones memoizadas: los campos y
+	//luego los metodos compilados
+	if (emitAsm || emitOptAsm || filter)
+	{
+		CCodeOutput output;
+		ostream code(&output);
+		compileHeader(code, stack);
+		code.write(methods.getData(), methods.getSize());
+	}
+	return 0;
+}
 
-	return result;
+/** Escribe las observaciones de las pasadas, si se pidieron con --remarks. **/
+static void writeRemarks()
+{
+	if (!remarks.isEnabled())
+	{
+		return;
+	}
+	cout << "Saving optimization remarks as \"" << remarksPath << "\"" << endl;
+	if (!remarks.write(filename))
+	{
+		cout << "Could not write the remarks file: " << remarksPath << endl;
+	}
 }
 
-void peephole(string infile, string outfile)
+/** Imprime las estadisticas de la compilacion y las guarda en JSON, y escribe la traza, si se pidieron. **/
+static void reportStats()
 {
-	ifstream in(infile.c_str());
-	ofstream out(outfile.c_str(), std::ios::out);
-	
-	string oldLine;
-	string newLine;
+	if (!compileStats.isEnabled())
+	{
+		return;
+	}
+	compileStats.enter(PH_NONE);
+	if (tracePath != NULL)
+	{
+		cout << "Saving trace as \"" << tracePath << "\"" << endl;
+		if (!tracer.close())
+		{
+			cout << "Could not write the trace file: " << tracePath << endl;
+		}
+	}
+	if (timePasses)
+	{
+		compileStats.report(cout);
+	}
+	if (statsJson != NULL)
+	{
+		cout << "Saving compilation statistics as \"" << statsJson << "\"" << endl;
+		ofstream json(statsJson, std::ios::out);
+		compileStats.writeJson(json, filename);
+	}
+}
 
-	if (!in.eof())
-		getline(in, oldLine);
+/** Analiza en paralelo cada parte del fuente. **/
+class CParseTask : public CParallelTask
+{
+	private:
+		vector<CParseChunk>& chunks;
+	public:
+		CParseTask(vector<CParseChunk>& c) : chunks(c) {}
 
-	if (!in.eof())
-		getline(in,newLine);
+		void run(int i)
+		{
+			chunks[i].result = parseChunk(&chunks[i]);
+		}
+};
 
-	while (!in.eof())
+int main(int argc, char* argv[])
+{
+	//Opciones: los argumentos que empiezan con "--", el resto es el archivo de entrada
+	const char* input = NULL;
+	for (int i = 1; i < argc; i++)
 	{
-		if ( (oldLine.size() > 0) && (newLine.size() > 0) && isSubStr(oldLine, "store") && isSubStr(newLine, "load") )
+		string arg(argv[i]);
+		if (arg == "--memoize")
+		{
+			passes.setEnabled("memoize", true);
+		}
+		else if (arg == "--memo-stats")
 		{
-			//Compara el segundo caracter (el 1ero es el tipo...), de las dos lineas para ver si coinciden.
-			if (oldLine[1] == newLine[1])
+			passes.setEnabled("memoize", true);
+			memoStats = true;
+		}
+		else if (arg.compare(0, 2, "-O") == 0)
+		{
+			if (arg.size() != 3 || !passes.setLevel(arg[2] - '0'))
 			{
-				string idAssemStore = subStrFromCh(oldLine, ' ');
-				string idAssemLoad = subStrFromCh(newLine, '_');
-
-				//Verifica que el store y el load sean sobre la misma variable
-				if (idAssemStore == idAssemLoad)
+				cout << "Unknown optimization level: " << arg << " (valid levels are -O0 to -O3)" << endl;
+				return -1;
+			}
+		}
+		else if (arg.compare(0, 2, "-f") == 0)
+		{
+			//-f<pasada> la habilita y -fno-<pasada> la deshabilita, sin importar el nivel
+			bool on = (arg.compare(0, 5, "-fno-") != 0);
+			string pass = arg.substr(on ? 2 : 5);
+			if (!passes.setEnabled(pass, on))
+			{
+				cout << "Unknown optimization pass: " << pass << " (see --print-passes)" << endl;
+				return -1;
+			}
+		}
+		else if (arg == "--print-passes")
+		{
+			printPasses = true;
+		}
+		else if (arg == "--licm-report")
+		{
+			licmReport = true;
+		}
+		else if (arg.compare(0, 7, "--jobs=") == 0)
+		{
+			jobs = atoi(arg.substr(7).c_str());
+		}
+		else if (arg == "--dump-tokens")
+		{
+			dumpTokensOnly = true;
+		}
+		else if (arg == "--stream")
+		{
+			stream = true;
+		}
+		else if (arg.compare(0, 7, "--emit=") == 0)
+		{
+			emitAst = emitOptAst = emitAsm = emitOptAsm = false;
+			istringstream kinds(arg.substr(7));
+			string kind;
+			while (getline(kinds, kind, ','))
+			{
+				if (kind == "ast")
+				{
+					emitAst = true;
+				}
+				else if (kind == "opt-ast")
+				{
+					emitOptAst = true;
+				}
+				else if (kind == "asm")
+				{
+					emitAsm = true;
+				}
+				else if (kind == "opt-asm")
 				{
-					out << "\tdup\n";
-					newLine = "\t;Store optimizado por PeepHole";
+					emitOptAsm = true;
+				}
+				else
+				{
+					cout << "Unknown output: " << kind << " (valid outputs are ast, opt-ast, asm and opt-asm)" << endl;
+					return -1;
 				}
 			}
 		}
+		else if (arg == "--filter")
+		{
+			filter = true;
+		}
+		else if (arg == "--unbuffered-output")
+		{
+			unbufferedOutput = true;
+		}
+		else if (arg == "--strip-debug")
+		{
+			debugInfo = false;
+		}
+		else if (arg == "--instrument")
+		{
+			instrument = true;
+		}
+		else if (arg == "--time-passes")
+		{
+			timePasses = true;
+		}
+		else if (arg.compare(0, 13, "--stats-json=") == 0)
+		{
+			statsJson = argv[i] + 13;
+		}
+		else if (arg.compare(0, 8, "--trace=") == 0)
+		{
+			tracePath = argv[i] + 8;
+		}
+		else if (arg.compare(0, 10, "--remarks=") == 0)
+		{
+			remarksPath = argv[i] + 10;
+		}
+		else if (arg.compare(0, 2, "--") == 0)
+		{
+			cout << "Unknown option: " << arg << endl;
+			return -1;
+		}
+		else
+		{
+			input = argv[i];
+		}
+	}
 
-		out << oldLine << "\n";
+	//Solo listar las pasadas, con las opciones dadas
+	if (printPasses)
+	{
+		passes.print(cout);
+		return 0;
+	}
 
-		oldLine = newLine;
-		getline(in, newLine);
+	//Con --filter el codigo optimizado va a la salida estandar y los mensajes a la de errores
+	if (filter)
+	{
+		cout.rdbuf(std::cerr.rdbuf());
 	}
-	out << oldLine << endl;
-	out.close();
-}
 
-bool isSubStr(string str, string subStr)
-{
-	if (str.size() < subStr.size())
-		return false;
+	//Desde aqui se mide cada etapa. La traza registra tambien las etapas que mide compileStats.
+	if (tracePath != NULL)
+	{
+		tracer.open(tracePath);
+	}
+	if (timePasses || statsJson != NULL || tracePath != NULL)
+	{
+		compileStats.enable();
+	}
+	if (remarksPath != NULL)
+	{
+		remarks.open(remarksPath);
+	}
+	compileStats.enter(PH_PARSE);
 
-	bool isSub = false;
-	for (int i = 0; i < str.size(); i++)
+	//Tomar el primer argumento como entrada, sino stdin.
+	FILE* in = stdin;
+	if (input != NULL)
+	{
+		if (!dumpTokensOnly)
+		{
+			cout << "Batch mode. taking as input: " << input << endl;
+		}
+		in = fopen(input, "rb");
+		filename = input;
+		sourceName = sourcePath(input);
+		if (in == NULL)
+		{
+			cout << "Could not open input file: " << input << endl;
+			return -1;
+		}
+	}
+	else
+	{
+		if (!dumpTokensOnly && !filter)
+		{
+			cout << "Interactive mode. Enter EOF to finish the program.\n"
+			     << "----------------------------------------------" << endl;
+		}
+		filename = "stdin";
+	}
+
+	//Compilar a medida que se lee
+	if (stream && !dumpTokensOnly)
+	{
+		int result = compileStream(in);
+		if (in != stdin)
+		{
+			fclose(in);
+		}
+		compileStats.enter(PH_TEARDOWN);
+		cout << "Freeing used memory..." << endl;
+		delete raiz;
+		writeRemarks();
+		reportStats();
+		return result;
+	}
+
+	//Se necesita toda la entrada, para poder dividirla. Un archivo se mapea en memoria y
+	//los scanners leen directamente de el; stdin se lee completo.
+	string source;
+	const char* data = NULL;
+	int size = 0;
+#ifndef _WIN32
+	void* mapped = MAP_FAILED;
+	struct stat info;
+	if (in != stdin && fstat(fileno(in), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+		if (mapped != MAP_FAILED)
+		{
+			data = (const char*)mapped;
+			size = info.st_size;
+		}
+	}
+#endif
+	if (data == NULL)
+	{
+		char buffer[65536];
+		size_t n;
+		while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		{
+			source.append(buffer, n);
+		}
+		data = source.data();
+		size = source.size();
+	}
+	if (in != stdin)
+	{
+		fclose(in);
+	}
+
+	//Solo listar los tokens de toda la entrada
+	if (dumpTokensOnly)
+	{
+		CParseChunk all;
+		all.text = data;
+		all.size = size;
+		all.firstLine = 1;
+		all.firstColumn = 1;
+		dumpTokens(&all, cout);
+		return 0;
+	}
+
+	//Parsear en paralelo las partes del fuente
+	vector<CParseChunk> chunks;
+	splitSource(data, size, chunks);
+	CParseTask parse(chunks);
+	parallelFor(chunks.size(), parse);
+
+	//Juntar las declaraciones en orden. Como el parser de todo el fuente, se detiene en el primer error
+	int result = 0;
+	for (unsigned int i = 0; i < chunks.size(); i++)
+	{
+		if (result == 0)
+		{
+			cout << chunks[i].messages;
+			result = chunks[i].result;
+			raiz->merge(chunks[i].root);
+		}
+		delete chunks[i].root;
+	}
+#ifndef _WIN32
+	if (mapped != MAP_FAILED)
+	{
+		munmap(mapped, size);
+	}
+#endif
+
+	//Imprimir mensaje de salida
+	if (result == 0)
 	{
-		int j = 0;
-		int h = i;
-		isSub = true;
-		while (h < str.size() && j < subStr.size())
+		cout << "Parsing successful" << endl;
+		if (compileStats.isEnabled())
 		{
-			if (str[h] != subStr[j])
-				isSub = false;
-			++j;
-			++h;
+			raiz->countNodes(compileStats.getNodes());
 		}
-		if (isSub && j == subStr.size())
-			return true;
+	}
+	else
+	{
+		cout << "Parse error, code: " << result << "\nAbort..." << endl;
+		abort();
+	}
+
+	//Pretty Print
+	if (emitAst)
+	{
+		compileStats.enter(PH_PRETTY_PRINT);
+		cout << "Pretty Printing result. Saving as \"out.txt\"" << endl;
+		ofstream out("out.txt",std::ios::out);
+		raiz->prettyPrint(out,0);
+		out.close();
 	}
 	
-	return false;
+	//Chequear Semantica
+	cout << "Begin semantic validation..." << endl;
+	CPilaDeSimbolos stack;
+	CFunctionTable functable;
+	
+	//Optimizar: pasadas sobre el arbol leido
+	compileStats.enter(PH_OPTIMIZE);
+	cout << "Optimizing..." << endl;
+	raiz->analyzePurity();
+	CPassContext passContext;
+	passContext.root = raiz;
+	passContext.stack = &stack;
+	passContext.functable = &functable;
+	passContext.licm = NULL;
+	passes.run(STAGE_AST, passContext);
+
+	//Pretty Print Optimizado
+	if (emitOptAst)
+	{
+		compileStats.enter(PH_PRETTY_PRINT);
+		cout << "Pretty Printing optimized code. Saving as \"opt.txt\"" << endl;
+		ofstream outopt("opt.txt",std::ios::out);
+		raiz->prettyPrint(outopt,0);
+		outopt.close();
+	}
+
+	//Funciones predefinidas del lenguaje
+	compileStats.enter(PH_SEMANTICS);
+	addBuiltins(functable);
+
+	raiz->checkSemantics(stack, functable);
+	if (semantics && (emitAsm || emitOptAsm || filter))
+	{
+		//Pasadas sobre el arbol validado: versiones de las funciones para llamadas con
+		//argumentos int y expresiones invariantes fuera de los ciclos
+		ostringstream licm;
+		passContext.licm = &licm;
+		passes.run(STAGE_CHECKED, passContext);
+		if (licmReport)
+		{
+			cout << "Saving loop invariant code motion report as \"licm.txt\"" << endl;
+			ofstream report("licm.txt", std::ios::out);
+			report << licm.str();
+			report.close();
+		}
+
+		//Asociar identificadores con variables y mantener en locales las globales de los ciclos
+		compileStats.enter(PH_RESOLVE);
+		raiz->resolve(stack, functable);
+
+		//Cabezal de la clase, variables globales, campos auxiliares y biblioteca estandar
+		//El codigo se guarda y se optimiza a nivel de codigo objeto a medida que se genera
+		compileStats.enter(PH_CODEGEN);
+		cout << "Compiling..." << endl;
+		CCodeOutput output;
+		ostream comp(&output);
+		compileHeader(comp, stack);
+
+		//Compilar si checksemantics todo ok.
+		raiz->compile(comp, functable);
+	}
+	else if (!semantics)
+	{
+		cout << "Semantic errors detected in source code. Aborting..." << endl;
+		result = -1;
+	}
+
+	//Liberar memoria
+	compileStats.enter(PH_TEARDOWN);
+	cout << "Freeing used memory..." << endl;
+	delete raiz;
+
+	writeRemarks();
+	reportStats();
+	return result;
+}
+
+bool isSubStr(const string& str, const char* subStr)
+{
+	return str.find(subStr) != string::npos;
 }
 
-string subStrFromCh(string str, char ch)
+string subStrFromCh(const string& str, char ch)
 {
 	bool existCh = false;
 	string result("");
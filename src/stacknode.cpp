@@ -41,6 +41,7 @@ CNodoPila::CNodoPila(TipoNodo tipoNodo, Tipo tipoDato, string strID, int asmID)
 
 	m_tipoDato = tipoDato;
 	m_tipoNodo = tipoNodo;
+	m_asignada = false;
 
 }
 
@@ -58,6 +59,7 @@ CNodoPila::CNodoPila(TipoNodo tipoNodo, Tipo tipoDato, string strID, int asmID)
 CNodoPila::CNodoPila( TipoNodo tipo ) : m_strID("__ALCANCE__")
 { 
 	m_tipoNodo = tipo; 
+	m_asignada = false;
 }
 
 /********************************************************************************************/
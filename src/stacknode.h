@@ -59,6 +59,9 @@ class CNodoPila {
 		// Identificador del numero de variable correspondiente al ID Node en assembler.
 		int m_asmID;
 
+		// Indica si a la variable se le asigna un valor en algun lugar del programa.
+		bool m_asignada;
+
 	public:
 
 		// Constructores...
@@ -85,6 +88,16 @@ class CNodoPila {
 			return m_asmID;
 		}
 
+		inline bool EsAsignada() {
+
+			return m_asignada;
+		}
+
+		inline void MarcarAsignada() {
+
+			m_asignada = true;
+		}
+
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////
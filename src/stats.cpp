@@ -0,0 +1,230 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+#include "trace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/resource.h>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+CCompileStats compileStats;
+
+//Nombres de las etapas, en el orden de EPhase
+static const char* phaseNames[PH_COUNT] =
+{
+	"lex/parse",
+	"pretty print",
+	"optimize",
+	"semantic check",
+	"loop invariants",
+	"resolve",
+	"stdlib copy",
+	"codegen",
+	"peephole",
+	"teardown"
+};
+
+/** Segundos del reloj indicado. **/
+static double now(clockid_t clock)
+{
+	struct timespec t;
+	clock_gettime(clock, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/** Memoria residente maxima del proceso en KB. **/
+static long peakRss()
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	//En Mac ru_maxrss esta en bytes
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/** Nombre legible de una clase a partir del de type_info. **/
+static string readableName(const string& mangled)
+{
+#ifdef __GNUG__
+	int status;
+	char* name = abi::__cxa_demangle(mangled.c_str(), NULL, NULL, &status);
+	if (status == 0 && name != NULL)
+	{
+		string result(name);
+		free(name);
+		return result;
+	}
+#endif
+	return mangled;
+}
+
+void writeJsonString(ostream& out, const string& s)
+{
+	out << '"';
+	for (unsigned int i = 0; i < s.size(); i++)
+	{
+		unsigned char c = s[i];
+		if (c == '"' || c == '\\')
+		{
+			out << '\\' << c;
+		}
+		else if (c < 0x20)
+		{
+			char escaped[8];
+			sprintf(escaped, "\\u%04x", c);
+			out << escaped;
+		}
+		else
+		{
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+/** Milisegundos con tres decimales. **/
+static string millis(double seconds)
+{
+	char text[32];
+	sprintf(text, "%.3f", seconds * 1000);
+	return text;
+}
+
+CCompileStats::CCompileStats() : enabled(false), current(PH_NONE), startWall(0), startCpu(0), nodes(true), symbolLookups(0), functionLookups(0)
+{
+	for (int i = 0; i < PH_COUNT; i++)
+	{
+		wall[i] = cpu[i] = 0;
+	}
+}
+
+void CCompileStats::enable()
+{
+	enabled = true;
+}
+
+EPhase CCompileStats::enter(EPhase phase)
+{
+	EPhase previous = current;
+	//Volver a entrar a la fase actual (ej. cada pasada de optimizacion) no parte su intervalo
+	if (!enabled || phase == current)
+	{
+		return previous;
+	}
+	double w = now(CLOCK_MONOTONIC);
+	double c = now(CLOCK_PROCESS_CPUTIME_ID);
+	if (current != PH_NONE)
+	{
+		wall[current] += w - startWall;
+		cpu[current] += c - startCpu;
+		tracer.complete(phaseNames[current], "phase", startWall, w, "");
+	}
+	current = phase;
+	startWall = w;
+	startCpu = c;
+	return previous;
+}
+
+map<string, long> CNodeCounts::getClasses()
+{
+	map<string, long> result;
+	for (map<string, long>::iterator it = classes.begin(); it != classes.end(); it++)
+	{
+		result[readableName(it->first)] += it->second;
+	}
+	return result;
+}
+
+void CCompileStats::report(ostream& out)
+{
+	double totalWall = 0;
+	double totalCpu = 0;
+	for (int i = 0; i < PH_COUNT; i++)
+	{
+		totalWall += wall[i];
+		totalCpu += cpu[i];
+	}
+
+	char line[128];
+	out << "\n===== Compilation statistics =====\n";
+	sprintf(line, "%-18s %12s %12s %7s\n", "phase", "wall (ms)", "cpu (ms)", "wall %");
+	out << line;
+	for (int i = 0; i < PH_COUNT; i++)
+	{
+		sprintf(line, "%-18s %12.3f %12.3f %6.1f%%\n", phaseNames[i], wall[i] * 1000, cpu[i] * 1000, (totalWall > 0) ? 100 * wall[i] / totalWall : 0.0);
+		out << line;
+	}
+	sprintf(line, "%-18s %12.3f %12.3f\n\n", "total", totalWall * 1000, totalCpu * 1000);
+	out << line;
+
+	out << "peak RSS:               " << peakRss() << " KB\n";
+	out << "symbol table lookups:   " << symbolLookups << "\n";
+	out << "function table lookups: " << functionLookups << "\n";
+
+	map<string, long> classes = nodes.getClasses();
+	out << "AST nodes:\n";
+	for (map<string, long>::iterator it = classes.begin(); it != classes.end(); it++)
+	{
+		sprintf(line, "  %-20s %10ld\n", it->first.c_str(), it->second);
+		out << line;
+	}
+	sprintf(line, "  %-20s %10ld\n", "total", nodes.total);
+	out << line;
+	out.flush();
+}
+
+void CCompileStats::writeJson(ostream& out, const char* source)
+{
+	double totalWall = 0;
+	double totalCpu = 0;
+	out << "{\n  \"source\": ";
+	writeJsonString(out, source);
+	out << ",\n  \"phases\": [\n";
+	for (int i = 0; i < PH_COUNT; i++)
+	{
+		out << "    {\"name\": \"" << phaseNames[i] << "\", \"wall_ms\": " << millis(wall[i]) << ", \"cpu_ms\": " << millis(cpu[i]) << "}";
+		out << ((i + 1 < PH_COUNT) ? ",\n" : "\n");
+		totalWall += wall[i];
+		totalCpu += cpu[i];
+	}
+	out << "  ],\n";
+	out << "  \"total\": {\"wall_ms\": " << millis(totalWall) << ", \"cpu_ms\": " << millis(totalCpu) << "},\n";
+	out << "  \"peak_rss_kb\": " << peakRss() << ",\n";
+	out << "  \"symbol_lookups\": " << symbolLookups << ",\n";
+	out << "  \"function_lookups\": " << functionLookups << ",\n";
+	out << "  \"ast_nodes\": {";
+	map<string, long> classes = nodes.getClasses();
+	for (map<string, long>::iterator it = classes.begin(); it != classes.end(); it++)
+	{
+		out << ((it == classes.begin()) ? "\n    " : ",\n    ");
+		writeJsonString(out, it->first);
+		out << ": " << it->second;
+	}
+	out << "\n  }\n}\n";
+}
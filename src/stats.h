@@ -0,0 +1,133 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <ostream>
+using std::ostream;
+
+#include <string>
+using std::string;
+
+#include <map>
+using std::map;
+
+#include <typeinfo>
+
+/** Etapas del compilador que se miden con --time-passes. **/
+enum EPhase
+{
+	PH_NONE = -1,
+	PH_PARSE,
+	PH_PRETTY_PRINT,
+	PH_OPTIMIZE,
+	PH_SEMANTICS,
+	PH_LICM,
+	PH_RESOLVE,
+	PH_STDLIB,
+	PH_CODEGEN,
+	PH_PEEPHOLE,
+	PH_TEARDOWN,
+	PH_COUNT
+};
+
+/**
+ * @class CNodeCounts
+ * @brief Cantidad de nodos de un AST, en total y opcionalmente por clase (ver Node::countNodes).
+ **/
+class CNodeCounts
+{
+	private:
+		bool byClass;
+		//Cantidad por nombre de type_info
+		map<string, long> classes;
+	public:
+		long total;
+
+		CNodeCounts(bool b = false) : byClass(b), total(0) {}
+
+		void add(const std::type_info& type)
+		{
+			total++;
+			if (byClass)
+			{
+				classes[type.name()]++;
+			}
+		}
+
+		/** Devuelve la cantidad por clase, con el nombre de la clase como en el fuente. **/
+		map<string, long> getClasses();
+};
+
+/**
+ * @class CCompileStats
+ * @brief Tiempos y contadores de una compilacion (--time-passes y --stats-json). El tiempo se
+ * acumula por etapa: en modo --stream las etapas se alternan para cada funcion. El tiempo de
+ * CPU es el de todo el proceso, por lo que en las etapas en paralelo suma el de todos los hilos.
+ **/
+class CCompileStats
+{
+	private:
+		bool enabled;
+		EPhase current;
+		double startWall;
+		double startCpu;
+		double wall[PH_COUNT];
+		double cpu[PH_COUNT];
+		//Nodos del AST leido
+		CNodeCounts nodes;
+	public:
+		//Busquedas en la tabla de simbolos y en la de funciones, de todos los hilos
+		long symbolLookups;
+		long functionLookups;
+
+		CCompileStats();
+
+		/** Empieza a medir. Sin invocarla, enter y los contadores no hacen nada. **/
+		void enable();
+		bool isEnabled() { return enabled; }
+
+		/** Termina la etapa actual y empieza phase, salvo que ya sea la actual. Devuelve la que termino, para poder volver a ella. **/
+		EPhase enter(EPhase phase);
+
+		/** Contadores de los nodos del AST leido, por clase. **/
+		CNodeCounts& getNodes() { return nodes; }
+
+		/** Imprime una tabla con los tiempos por etapa y los contadores. **/
+		void report(ostream& out);
+
+		/** Escribe los mismos datos en JSON, para comparar compilaciones. **/
+		void writeJson(ostream& out, const char* source);
+};
+
+extern CCompileStats compileStats;
+
+/** Escribe s como string de JSON, entre comillas. **/
+void writeJsonString(ostream& out, const string& s);
+
+/** Suma uno a un contador de compileStats. Es atomico porque las pasadas corren en paralelo. **/
+inline void countStat(long& counter)
+{
+	if (compileStats.isEnabled())
+	{
+		__sync_fetch_and_add(&counter, 1);
+	}
+}
+
+#endif
@@ -23,6 +23,7 @@ using std::cout;
 using std::endl;
 
 # include "symbolstack.h"
+# include "stats.h"
 
 //////////////////////////////// Implementacin de Clase /////////////////////////////////////
 
@@ -144,6 +145,8 @@ void CPilaDeSimbolos::FinMarcador(TipoNodo mark)
 
 bool CPilaDeSimbolos::EstaVarDefinida( string strID ) {
 
+	countStat(compileStats.symbolLookups);
+
 	std::list< CNodoPila >::iterator i;
 	for ( i = m_lista.begin() ; i != m_lista.end() ; i++ ) {
 
@@ -161,6 +164,8 @@ bool CPilaDeSimbolos::EstaVarDefinida( string strID ) {
 
 bool CPilaDeSimbolos::EstaVarEnAlcance( string strID ) {
 
+	countStat(compileStats.symbolLookups);
+
 	std::list< CNodoPila >::iterator i;
 	for ( i = m_lista.begin() ; (i != m_lista.end()) && (i->GetTipoNodo() != INI_ALCANCE) ; i++ ) {
 
@@ -178,6 +183,8 @@ bool CPilaDeSimbolos::EstaVarEnAlcance( string strID ) {
 
 ExpType CPilaDeSimbolos::getTipo( string strID ) {
 
+	countStat(compileStats.symbolLookups);
+
 	std::list< CNodoPila >::iterator i;
 	for ( i = m_lista.begin() ; i != m_lista.end() ; i++ ) {
 
@@ -207,6 +214,7 @@ ExpType CPilaDeSimbolos::getCurrFuncType()
 
 int CPilaDeSimbolos::GetAsmID( string strID )
 {
+	countStat(compileStats.symbolLookups);
 	list< CNodoPila >::iterator it = m_lista.begin();
 	while (it != m_lista.end()) //it->GetTipoNodo() != INI_FUNCION
 	{
@@ -219,6 +227,60 @@ int CPilaDeSimbolos::GetAsmID( string strID )
 	return -2; //Error
 }
 
+/********************************************************************************************/
+
+void CPilaDeSimbolos::MarcarAsignada( string strID )
+{
+	countStat(compileStats.symbolLookups);
+	for (list< CNodoPila >::iterator it = m_lista.begin(); it != m_lista.end(); it++)
+	{
+		if (it->GetTipoNodo() == DEF_VAR && it->GetID() == strID)
+		{
+			it->MarcarAsignada();
+			return;
+		}
+	}
+}
+
+/********************************************************************************************/
+
+/**
+ *
+ * Copia las globales de otra pila, que solo debe contener globales. Como la pila crece
+ * hacia el frente, las primeras definidas son las ultimas de la lista.
+ *
+ */
+
+void CPilaDeSimbolos::CopiarGlobales( CPilaDeSimbolos& otra, int count )
+{
+	list< CNodoPila >::iterator it = otra.m_lista.end();
+	if (count < 0 || count > (int)otra.m_lista.size())
+	{
+		count = otra.m_lista.size();
+	}
+	for (int i = 0; i < count; i++)
+	{
+		--it;
+	}
+	m_lista.assign(it, otra.m_lista.end());
+}
+
+/********************************************************************************************/
+
+void CPilaDeSimbolos::CombinarAsignadas( CPilaDeSimbolos& otra )
+{
+	//Esta pila es una copia de las globales mas antiguas de la otra, se recorren desde el final
+	list< CNodoPila >::reverse_iterator it = m_lista.rbegin();
+	list< CNodoPila >::reverse_iterator dest = otra.m_lista.rbegin();
+	for ( ; it != m_lista.rend() && dest != otra.m_lista.rend(); it++, dest++)
+	{
+		if (it->EsAsignada())
+		{
+			dest->MarcarAsignada();
+		}
+	}
+}
+
 /********************************************************************************************/
 string CPilaDeSimbolos::getCurrFuncID()
 {
@@ -65,6 +65,15 @@ class CPilaDeSimbolos {
 		
 		int GetAsmID( string strID );
 
+		/** Registra que a la variable visible con ese nombre se le asigna un valor. **/
+		void MarcarAsignada( string strID );
+
+		/** Copia las primeras count variables globales definidas en otra pila (todas si es -1). **/
+		void CopiarGlobales( CPilaDeSimbolos& otra, int count );
+
+		/** Marca como asignadas en otra pila las globales que se asignaron en esta copia. **/
+		void CombinarAsignadas( CPilaDeSimbolos& otra );
+
 		ExpType getTipo( string strID );
 
 		/** Devuelve el tipo de retorno de la funcion actual en la pila **/
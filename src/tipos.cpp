@@ -31,6 +31,18 @@ ExpType util::Tipo2ExpType(Tipo tipo)
 	}
 }
 
+bool util::ExpType2Tipo(ExpType et, Tipo& tipo)
+{
+	switch(et)
+	{
+		case ET_BOOL: tipo = TBOOL; return true;
+		case ET_INT: tipo = TINT; return true;
+		case ET_FLOAT: tipo = TFLOAT; return true;
+		case ET_STRING: tipo = TSTRING; return true;
+		default: return false;
+	}
+}
+
 //
 //Utilidades
 //
@@ -60,28 +72,75 @@ void util::prettyPrint(ostream& out, Tipo t, int depth)
 	}
 }
 /** Compilacion de tipos **/
-string util::compile(ExpType et)
+const char* util::compile(ExpType et)
 {
 	switch (et)
 	{
-		case ET_INT: return string("I");
-		case ET_BOOL: return string("Z");
-		case ET_FLOAT: return string("F");
-		case ET_STRING: return string("Ljava/lang/String;");
-		case ET_VOID: return string("V");
+		case ET_INT: return "I";
+		case ET_BOOL: return "Z";
+		case ET_FLOAT: return "F";
+		case ET_STRING: return "Ljava/lang/String;";
+		case ET_VOID: return "V";
 		default: cout << "Compiler Bug: Impossible to compile given type" << endl; abort(); //No deberia entrar aqui
 	}
 }
 
 /** Compilacion de tipos para instrucciones **/
-string util::compileInst(ExpType et)
+const char* util::compileInst(ExpType et)
+{
+	switch (et)
+	{
+		case ET_INT: return "i";
+		case ET_BOOL: return "i";
+		case ET_FLOAT: return "f";
+		case ET_STRING: return "a";
+		default: cout << "Compiler Bug: Impossible to compile given type" << endl; abort(); //No deberia entrar aqui
+	}
+}
+
+/** Compilacion de accesos a variables locales **/
+util::CLocalInst util::compileLocal(ExpType et, const char* inst, int slot)
+{
+	CLocalInst local = { et, inst, slot };
+	return local;
+}
+
+ostream& operator<<(ostream& out, const util::CLocalInst& local)
+{
+	out << util::compileInst(local.type) << local.inst;
+	//La JVM solo tiene formas cortas para los primeros 4 slots
+	if (local.slot <= 3)
+	{
+		out << "_" << local.slot;
+	}
+	else
+	{
+		out << " " << local.slot;
+	}
+	return out;
+}
+
+/** Compilacion de conversiones entre primitivos y objetos **/
+const char* util::compileBox(ExpType et)
+{
+	switch (et)
+	{
+		case ET_INT: return "invokestatic java/lang/Integer/valueOf(I)Ljava/lang/Integer;";
+		case ET_BOOL: return "invokestatic java/lang/Boolean/valueOf(Z)Ljava/lang/Boolean;";
+		case ET_FLOAT: return "invokestatic java/lang/Float/valueOf(F)Ljava/lang/Float;";
+		case ET_STRING: return "";
+		default: cout << "Compiler Bug: Impossible to compile given type" << endl; abort(); //No deberia entrar aqui
+	}
+}
+
+const char* util::compileUnbox(ExpType et)
 {
 	switch (et)
 	{
-		case ET_INT: return string("i");
-		case ET_BOOL: return string("i");
-		case ET_FLOAT: return string("f");
-		case ET_STRING: return string("a");
+		case ET_INT: return "checkcast java/lang/Integer\n\tinvokevirtual java/lang/Integer/intValue()I";
+		case ET_BOOL: return "checkcast java/lang/Boolean\n\tinvokevirtual java/lang/Boolean/booleanValue()Z";
+		case ET_FLOAT: return "checkcast java/lang/Float\n\tinvokevirtual java/lang/Float/floatValue()F";
+		case ET_STRING: return "checkcast java/lang/String";
 		default: cout << "Compiler Bug: Impossible to compile given type" << endl; abort(); //No deberia entrar aqui
 	}
 }
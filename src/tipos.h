@@ -39,13 +39,40 @@ namespace util
 
 	ExpType Tipo2ExpType(Tipo);
 
+	/** Conversion inversa de Tipo2ExpType. Devuelve false si el tipo no es declarable. **/
+	bool ExpType2Tipo(ExpType, Tipo&);
+
 	void indent(ostream&, int);
 
 	void prettyPrint(ostream&, Tipo, int);
 
-	string compile(ExpType);
+	//Las compilaciones de tipos devuelven textos constantes, no se crea nada en cada llamada
+
+	const char* compile(ExpType);
+
+	const char* compileInst(ExpType);
+
+	/**
+	 * @class CLocalInst
+	 * @brief Load o store de una variable local, se escribe directamente en el ostream.
+	 **/
+	struct CLocalInst
+	{
+		ExpType type;
+		const char* inst;
+		int slot;
+	};
 
-	string compileInst(ExpType);
+	/** Compila un load o store de una variable local, ej: iload_1, fstore 5 **/
+	CLocalInst compileLocal(ExpType, const char*, int);
+
+	/** Compila la conversion de un valor primitivo a objeto (Integer, Float, Boolean) **/
+	const char* compileBox(ExpType);
+
+	/** Compila la conversion inversa de compileBox, a partir de un Object **/
+	const char* compileUnbox(ExpType);
 }
+
+ostream& operator<<(ostream&, const util::CLocalInst&);
 
 #endif
@@ -0,0 +1,150 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace.h"
+#include "stats.h"
+
+#include <cstdio>
+#include <ctime>
+
+#include <fstream>
+using std::ofstream;
+
+#include <sstream>
+using std::ostringstream;
+
+CTracer tracer;
+
+//Numero del hilo actual en la traza, -1 si todavia no registro eventos
+static __thread int threadId = -1;
+
+CTracer::CTracer() : enabled(false), origin(0), threads(0)
+{
+	pthread_mutex_init(&mutex, NULL);
+}
+
+CTracer::~CTracer()
+{
+	pthread_mutex_destroy(&mutex);
+}
+
+void CTracer::open(const char* p)
+{
+	path = p;
+	enabled = true;
+	origin = now();
+	//El hilo principal es el primero
+	threadId = threads++;
+}
+
+double CTracer::now()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+void CTracer::complete(const string& name, const char* category, double start, double end, const string& args)
+{
+	if (!enabled)
+	{
+		return;
+	}
+	//Tiempos en microsegundos, como pide el formato
+	char times[96];
+	sprintf(times, "\"ts\": %.3f, \"dur\": %.3f", (start - origin) * 1e6, (end - start) * 1e6);
+
+	ostringstream event;
+	event << "{\"name\": ";
+	writeJsonString(event, name);
+	event << ", \"cat\": \"" << category << "\", \"ph\": \"X\", " << times << ", \"pid\": 1, \"tid\": ";
+
+	pthread_mutex_lock(&mutex);
+	if (threadId < 0)
+	{
+		threadId = threads++;
+	}
+	event << threadId << ", \"args\": {" << args << "}}";
+	events.push_back(event.str());
+	pthread_mutex_unlock(&mutex);
+}
+
+bool CTracer::close()
+{
+	if (!enabled)
+	{
+		return true;
+	}
+	enabled = false;
+	ofstream out(path.c_str(), std::ios::out);
+	out << "{\"traceEvents\": [\n";
+	//Nombres de los hilos: el primero en registrar eventos es el principal
+	out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"lpc\"}}";
+	for (int i = 0; i < threads; i++)
+	{
+		out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << i << ", \"args\": {\"name\": \"";
+		if (i == 0)
+		{
+			out << "main";
+		}
+		else
+		{
+			out << "worker " << i;
+		}
+		out << "\"}}";
+	}
+	for (unsigned int i = 0; i < events.size(); i++)
+	{
+		out << ",\n" << events[i];
+	}
+	out << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+	events.clear();
+	out.close();
+	return !out.fail();
+}
+
+CTraceSpan::CTraceSpan(const char* n, const string& f) : name(n), start(0)
+{
+	if (tracer.isEnabled())
+	{
+		function = f;
+		start = tracer.now();
+	}
+}
+
+CTraceSpan::~CTraceSpan()
+{
+	if (tracer.isEnabled())
+	{
+		string title(name);
+		title += " ";
+		title += function;
+		ostringstream allArgs;
+		allArgs << "\"function\": ";
+		writeJsonString(allArgs, function);
+		allArgs << args;
+		tracer.complete(title, name, start, tracer.now(), allArgs.str());
+	}
+}
+
+void CTraceSpan::arg(const char* key, long value)
+{
+	ostringstream text;
+	text << ", \"" << key << "\": " << value;
+	args += text.str();
+}
@@ -0,0 +1,92 @@
+/*
+ *  LPC - The L+ Compiler. A compiler for a toy language similar to C.
+ *  Copyright (C) 2011  Alejandro Segovia and Emilio Pombo
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <pthread.h>
+
+/**
+ * @class CTracer
+ * @brief Registro de lo que hace el compilador en el formato de eventos de Chrome (--trace),
+ * para abrirlo en Perfetto o chrome://tracing. Cada intervalo es un evento completo ("X") con
+ * el hilo que lo ejecuto; los eventos se guardan en memoria y se escriben al final.
+ **/
+class CTracer
+{
+	private:
+		bool enabled;
+		string path;
+		//Tiempo de open, los eventos se registran desde alli
+		double origin;
+		vector<string> events;
+		//Cantidad de hilos que registraron eventos
+		int threads;
+		pthread_mutex_t mutex;
+	public:
+		CTracer();
+		~CTracer();
+
+		/** Empieza a registrar eventos, que se escriben en path al invocar close. **/
+		void open(const char* path);
+		bool isEnabled() { return enabled; }
+
+		/** Segundos del reloj monotono, el mismo que usa CCompileStats. **/
+		double now();
+
+		/**
+		 * Registra un intervalo del hilo actual. start y end son tiempos de now(); args es el
+		 * contenido del objeto "args" del evento, en JSON (puede ser vacio).
+		 **/
+		void complete(const string& name, const char* category, double start, double end, const string& args);
+
+		/** Escribe el archivo. Devuelve false si no se pudo escribir. **/
+		bool close();
+};
+
+extern CTracer tracer;
+
+/**
+ * @class CTraceSpan
+ * @brief Intervalo de una pasada sobre una funcion: empieza al crearse y se registra al
+ * destruirse, con los valores agregados con arg. Sin --trace no hace nada.
+ **/
+class CTraceSpan
+{
+	private:
+		const char* name;
+		string function;
+		double start;
+		string args;
+	public:
+		CTraceSpan(const char* n, const string& f);
+		~CTraceSpan();
+
+		bool isActive() { return tracer.isEnabled(); }
+
+		/** Agrega un valor numerico al evento. **/
+		void arg(const char* key, long value);
+};
+
+#endif